@@ -18,10 +18,38 @@
 
 namespace neonGX {
 
+  class InputHandle;
+  class RenderTexture;
+  class Sprite;
+
   class Container : public DisplayObject {
+  public:
+    friend class SpatialIndex;
+
   private:
     std::vector<std::shared_ptr<DisplayObject>> m_Children;
 
+    // Destroyed before the children, it still refers to them.
+    std::unique_ptr<SpatialIndex> m_SpatialIndex;
+    std::vector<DisplayObject*> m_VisibleObjects;
+
+    // cacheAsBitmap: the subtree is drawn into m_CacheTexture once and
+    // replaced by m_CacheSprite until something in it changes.
+    bool m_CacheAsBitmap = false;
+    bool m_CacheDirty = true;
+    bool m_RenderingCache = false;
+
+    Affine2D m_CachedWorldTransform;
+    float m_CachedWorldAlpha = 1;
+
+    std::shared_ptr<RenderTexture> m_CacheTexture;
+    std::shared_ptr<Sprite> m_CacheSprite;
+
+    void RenderCachedBitmap(GLRenderer* renderer);
+
+  protected:
+    void OnChildChanged(DisplayObject* origin) override;
+
   public:
     Container();
     virtual ~Container();
@@ -36,7 +64,45 @@ namespace neonGX {
     NRectangle GetBounds() override;
     NRectangle GetLocalBounds() override;
 
-    virtual void OnStateChanged() override {
+    // Union of the cached bounds of the visible children.
+    optional<NRectangle> GetCachedWorldBounds() override;
+
+    virtual void OnStateChanged() override;
+
+    // Children are tested front to back, the first hit wins. With a
+    // spatial index only the objects indexed at the point are tested.
+    DisplayObject* HitTest(const FPoint& point) override;
+
+    // Topmost object under the mouse cursor.
+    DisplayObject* HitTest(const InputHandle& input);
+
+    // Keeps a dynamic AABB tree over the objects drawn by the subtree,
+    // which then replaces the tree walk when rendering: only objects within
+    // the render target are visited. Meant for the root container of large
+    // scenes, indices can not be nested.
+    void SetSpatialIndexEnabled(bool enabled);
+
+    SpatialIndex* GetSpatialIndex() override {
+      return m_SpatialIndex.get();
+    }
+
+    bool RendersChildren() const override {
+      return !m_CacheAsBitmap;
+    }
+
+    bool GetCacheAsBitmap() const {
+      return m_CacheAsBitmap;
+    }
+
+    // Meant for static subtrees. The bitmap is kept in world space, moving
+    // the container or one of its parents renders it again. Ignored while
+    // the renderer runs a render thread.
+    void SetCacheAsBitmap(bool cacheAsBitmap);
+
+    // Forces the bitmap to be rendered again, for changes the container
+    // can not observe.
+    void InvalidateCache() {
+      m_CacheDirty = true;
     }
 
     void RenderWebGL(GLRenderer* renderer) override;
@@ -12,17 +12,21 @@
 #define NEONGX_DISPLAYOBJECT_H
 
 #include <neonGX/Core/Math/Primitives.hpp>
-#include <neonGX/Core/Math/Matrix.hpp>
+#include <neonGX/Core/Math/Affine2D.hpp>
 #include <neonGX/Core/Math/Transformation.hpp>
 #include <neonGX/Core/Renderer/Renderer.hpp>
+#include <neonGX/Core/ADT.hpp>
 
 namespace neonGX {
 
   class Container;
   class GLRenderer;
+  class SpatialIndex;
 
   class DisplayObject {
   public:
+    friend class SpatialIndex;
+
     DisplayObject();
     virtual ~DisplayObject();
 
@@ -38,8 +42,41 @@ namespace neonGX {
     bool m_Visible = true;
     bool m_Renderable = true;
 
-    Matrix3 m_LocalTransform;
-    Matrix3 m_WorldTransform = GetIdentityTransform();
+    // Most significant part of the render command sort key.
+    uint8_t m_RenderLayer = 0;
+
+    // Set whenever the object may look different, consumed by the damage
+    // tracking of partial redraws.
+    bool m_RenderChanged = true;
+
+    Affine2D m_LocalTransform;
+    Affine2D m_WorldTransform;
+
+    // Transform updates only recompute what changed. The setters mark the
+    // local transform dirty and flag every ancestor, world transforms are
+    // recomputed when the local one or the world of the parent changed.
+    bool m_LocalTransformDirty = true;
+    bool m_WorldTransformDirty = true;
+    // Set when a child needs its transform updated.
+    bool m_ChildTransformDirty = true;
+
+    // Incremented whenever the world transform or alpha changes.
+    uint32_t m_WorldVersion = 0;
+
+    // The parent and its version the world transform was computed from.
+    const DisplayObject* m_TransformParent = nullptr;
+    uint32_t m_ParentWorldVersion = 0;
+
+    // Inverse of m_WorldTransform for hit testing, computed on first use
+    // after the world transform changed. nullopt for degenerate transforms.
+    optional<Affine2D> m_InverseWorldTransform;
+    bool m_InverseWorldTransformValid = false;
+
+    // World space AABB of what the object draws. Computed along with the
+    // transformed geometry and invalidated whenever the object or one of
+    // its descendants changes.
+    NRectangle m_WorldBounds{};
+    bool m_WorldBoundsValid = false;
 
     float m_WorldAlpha = 1;
 
@@ -47,8 +84,73 @@ namespace neonGX {
 
     NRectangle bounds{{0, 0}, {1, 1}};
 
+    // Leaf of the spatial index of an ancestor, see SpatialIndex.
+    int32_t m_SpatialProxy = -1;
+    // Position within the dirty list of that index, -1 while not queued.
+    int32_t m_SpatialDirtyIndex = -1;
+    uint32_t m_DrawOrder = 0;
+
     void SetRemoteDOParent(DisplayObject* displayObject, bool null = false) {
       displayObject->m_Parent = null ? nullptr : this;
+      if(null) {
+        displayObject->MarkRenderChanged();
+      } else {
+        displayObject->MarkParentsTransformDirty();
+        displayObject->ContentChanged();
+      }
+    }
+
+    // Recomputes the world transform and alpha if they are out of date.
+    void UpdateWorldTransform(bool UseIdentityTransform);
+
+    // Brings the world transforms from the root down to this object up to
+    // date, for queries between frames.
+    void UpdateTransformPath();
+
+    void MarkParentsTransformDirty() {
+      for(DisplayObject* obj = m_Parent; obj != nullptr;
+          obj = obj->m_Parent) {
+        obj->m_ChildTransformDirty = true;
+      }
+    }
+
+    // Called after the world transform changed, geometry derived from it
+    // has to be recomputed.
+    virtual void OnWorldTransformChanged() {
+    }
+
+    // Called on every ancestor when a descendant changed in a way that
+    // affects how the subtree renders. origin is the changed object, null
+    // if children were only removed.
+    virtual void OnChildChanged(DisplayObject* origin) {
+      (void)origin;
+    }
+
+    void NotifyParentsChanged(DisplayObject* origin);
+
+    // Whether the object covers the point, given in its local space.
+    virtual bool HitTestLocal(const FPoint& point) {
+      (void)point;
+      return false;
+    }
+
+    // For changes of the content rather than the transform.
+    void ContentChanged() {
+      MarkRenderChanged();
+      m_WorldBoundsValid = false;
+      NotifyParentsChanged(this);
+    }
+
+    void StateChanged() {
+      OnStateChanged();
+      ContentChanged();
+    }
+
+    // For changes of the local transform.
+    void TransformChanged() {
+      m_LocalTransformDirty = true;
+      MarkParentsTransformDirty();
+      StateChanged();
     }
 
   public:
@@ -60,7 +162,7 @@ namespace neonGX {
       if(position == m_Position) {
         return;
       }
-      OnStateChanged();
+      TransformChanged();
       m_Position = position;
     }
 
@@ -72,7 +174,7 @@ namespace neonGX {
       if(scale == m_Scale) {
         return;
       }
-      OnStateChanged();
+      TransformChanged();
       m_Scale = scale;
     }
 
@@ -84,7 +186,7 @@ namespace neonGX {
       if(pivot == m_Pivot) {
         return;
       }
-      OnStateChanged();
+      TransformChanged();
       m_Pivot = pivot;
     }
 
@@ -96,7 +198,7 @@ namespace neonGX {
       if(skew == m_Skew) {
         return;
       }
-      OnStateChanged();
+      TransformChanged();
       m_Skew = skew;
     }
 
@@ -108,7 +210,7 @@ namespace neonGX {
       if(rotation == m_Rotation) {
         return;
       }
-      OnStateChanged();
+      TransformChanged();
       m_Rotation = rotation;
     }
 
@@ -120,7 +222,9 @@ namespace neonGX {
       if(alpha == m_Alpha) {
         return;
       }
-      OnStateChanged();
+      m_WorldTransformDirty = true;
+      MarkParentsTransformDirty();
+      StateChanged();
       m_Alpha = alpha;
     }
 
@@ -134,10 +238,44 @@ namespace neonGX {
       if(visible == m_Visible) {
         return;
       }
-      OnStateChanged();
+      // Transforms of hidden containers are not kept up to date.
+      MarkParentsTransformDirty();
+      StateChanged();
       m_Visible = visible;
     }
 
+    uint8_t GetRenderLayer() const {
+      return m_RenderLayer;
+    }
+
+    void SetRenderLayer(uint8_t layer) {
+      if(layer == m_RenderLayer) {
+        return;
+      }
+      m_RenderLayer = layer;
+      MarkRenderChanged();
+    }
+
+    const Affine2D& GetWorldTransform() const {
+      return m_WorldTransform;
+    }
+
+    float GetWorldAlpha() const {
+      return m_WorldAlpha;
+    }
+
+    void MarkRenderChanged() {
+      m_RenderChanged = true;
+    }
+
+    bool ConsumeRenderChanged() {
+      bool changed = m_RenderChanged;
+      m_RenderChanged = false;
+      return changed;
+    }
+
+    const optional<Affine2D>& GetInverseWorldTransform();
+
     FPoint ToGlobalPosition(const FPoint& position);
     FPoint ToLocalPosition(const FPoint& position, DisplayObject* fromObj);
 
@@ -149,6 +287,33 @@ namespace neonGX {
       return GetBounds();
     }
 
+    // Bounds for culling, nullopt while unknown. Objects with unknown
+    // bounds are never culled.
+    virtual optional<NRectangle> GetCachedWorldBounds() {
+      if(!m_WorldBoundsValid) {
+        return nullopt;
+      }
+      return m_WorldBounds;
+    }
+
+    // The index maintained by this object, only containers have one.
+    virtual SpatialIndex* GetSpatialIndex() {
+      return nullptr;
+    }
+
+    // Nearest index maintained by this object or one of its ancestors.
+    SpatialIndex* FindSpatialIndex();
+
+    // False for objects drawing their children themselves, or not at all.
+    virtual bool RendersChildren() const {
+      return false;
+    }
+
+    // Topmost object drawn at the world space point, this one or one of
+    // its descendants, null if there is none. Tested front to back against
+    // the world transforms of the last frame.
+    virtual DisplayObject* HitTest(const FPoint& point);
+
     virtual void OnStateChanged() = 0;
 
     virtual void RenderWebGL(GLRenderer* renderer) = 0;
@@ -0,0 +1,236 @@
+/*
+ * neonGX - DynamicAABBTree.hpp
+ *
+ * Copyright (c) 2016, cynecx
+ *
+ * This file is part of neonGX and is distributed under a modified
+ * BSD 3-Clause License. See LICENSE.txt for details.
+ *
+ */
+
+#ifndef NEONGX_DYNAMICAABBTREE_H
+#define NEONGX_DYNAMICAABBTREE_H
+
+#include <neonGX/Core/Math/Primitives.hpp>
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+namespace neonGX {
+
+  class DisplayObject;
+
+  struct AABB {
+    float MinX = 0.0f;
+    float MinY = 0.0f;
+    float MaxX = 0.0f;
+    float MaxY = 0.0f;
+
+    static AABB FromRectangle(const NRectangle& rect) {
+      return {
+          float(rect.point.x), float(rect.point.y),
+          float(rect.point.x + rect.size.width),
+          float(rect.point.y + rect.size.height)
+      };
+    }
+
+    static AABB FromRectangle(const FRectangle& rect) {
+      return {
+          rect.point.x, rect.point.y,
+          rect.point.x + rect.size.width, rect.point.y + rect.size.height
+      };
+    }
+
+    static AABB Union(const AABB& a, const AABB& b) {
+      return {
+          std::min(a.MinX, b.MinX), std::min(a.MinY, b.MinY),
+          std::max(a.MaxX, b.MaxX), std::max(a.MaxY, b.MaxY)
+      };
+    }
+
+    bool Overlaps(const AABB& rhs) const {
+      return MinX <= rhs.MaxX && rhs.MinX <= MaxX &&
+             MinY <= rhs.MaxY && rhs.MinY <= MaxY;
+    }
+
+    bool Contains(const AABB& rhs) const {
+      return MinX <= rhs.MinX && MinY <= rhs.MinY &&
+             rhs.MaxX <= MaxX && rhs.MaxY <= MaxY;
+    }
+
+    bool Contains(const FPoint& point) const {
+      return MinX <= point.x && point.x <= MaxX &&
+             MinY <= point.y && point.y <= MaxY;
+    }
+
+    float GetPerimeter() const {
+      return 2.0f * ((MaxX - MinX) + (MaxY - MinY));
+    }
+  };
+
+  // Bounding volume hierarchy over display objects, balanced by tree
+  // rotations on every insertion and removal.
+  //
+  // Leaves store fattened bounds, objects moving within their margin do
+  // not touch the tree at all.
+  class DynamicAABBTree {
+  public:
+    static constexpr int32_t NullNode = -1;
+
+  private:
+    struct Node {
+      AABB Bounds;
+      DisplayObject* Object = nullptr;
+      // Next free node while the node is on the free list.
+      int32_t Parent = NullNode;
+      int32_t Child1 = NullNode;
+      int32_t Child2 = NullNode;
+      // Leaves are 0, free nodes -1.
+      int32_t Height = -1;
+
+      bool IsLeaf() const {
+        return Child1 == NullNode;
+      }
+    };
+
+    std::vector<Node> m_Nodes;
+    int32_t m_Root = NullNode;
+    int32_t m_FreeList = NullNode;
+    size_t m_ProxyCount = 0;
+    float m_Margin;
+
+    int32_t AllocateNode();
+    void FreeNode(int32_t node);
+
+    void InsertLeaf(int32_t leaf);
+    void RemoveLeaf(int32_t leaf);
+    void Refit(int32_t node);
+
+    int32_t Balance(int32_t node);
+
+  public:
+    explicit DynamicAABBTree(float margin = 8.0f) : m_Margin(margin) {
+    }
+
+    int32_t CreateProxy(const AABB& bounds, DisplayObject* object);
+    void DestroyProxy(int32_t proxy);
+
+    // Returns true if the proxy left its fat bounds and was reinserted.
+    bool MoveProxy(int32_t proxy, const AABB& bounds);
+
+    DisplayObject* GetObject(int32_t proxy) const {
+      assert(proxy >= 0 && size_t(proxy) < m_Nodes.size());
+      return m_Nodes[size_t(proxy)].Object;
+    }
+
+    const AABB& GetFatBounds(int32_t proxy) const {
+      assert(proxy >= 0 && size_t(proxy) < m_Nodes.size());
+      return m_Nodes[size_t(proxy)].Bounds;
+    }
+
+    size_t GetProxyCount() const {
+      return m_ProxyCount;
+    }
+
+    int32_t GetHeight() const {
+      return m_Root == NullNode ? 0 : m_Nodes[size_t(m_Root)].Height;
+    }
+
+    // Calls callback(proxy) for every proxy whose fat bounds overlap the
+    // given bounds.
+    template <typename Callback>
+    void Query(const AABB& bounds, Callback&& callback) const {
+      std::vector<int32_t> stack;
+      if(m_Root != NullNode) {
+        stack.push_back(m_Root);
+      }
+
+      while(!stack.empty()) {
+        int32_t nodeId = stack.back();
+        const Node& node = m_Nodes[size_t(nodeId)];
+        stack.pop_back();
+
+        if(!node.Bounds.Overlaps(bounds)) {
+          continue;
+        }
+
+        if(node.IsLeaf()) {
+          callback(nodeId);
+        } else {
+          stack.push_back(node.Child1);
+          stack.push_back(node.Child2);
+        }
+      }
+    }
+
+    // Calls callback(proxy, fraction) for every proxy whose fat bounds the
+    // segment from -> to crosses, fraction being where it enters them.
+    template <typename Callback>
+    void Raycast(const FPoint& from, const FPoint& to,
+                 Callback&& callback) const {
+      float dx = to.x - from.x;
+      float dy = to.y - from.y;
+
+      // Slab test, returns the entry fraction or a negative value.
+      auto intersect = [&](const AABB& bounds) -> float {
+        float tMin = 0.0f;
+        float tMax = 1.0f;
+
+        const float origin[2] = {from.x, from.y};
+        const float delta[2] = {dx, dy};
+        const float lower[2] = {bounds.MinX, bounds.MinY};
+        const float upper[2] = {bounds.MaxX, bounds.MaxY};
+
+        for(size_t axis = 0; axis < 2; axis++) {
+          if(delta[axis] == 0.0f) {
+            if(origin[axis] < lower[axis] || origin[axis] > upper[axis]) {
+              return -1.0f;
+            }
+            continue;
+          }
+
+          float t1 = (lower[axis] - origin[axis]) / delta[axis];
+          float t2 = (upper[axis] - origin[axis]) / delta[axis];
+          if(t1 > t2) {
+            std::swap(t1, t2);
+          }
+
+          tMin = std::max(tMin, t1);
+          tMax = std::min(tMax, t2);
+          if(tMin > tMax) {
+            return -1.0f;
+          }
+        }
+
+        return tMin;
+      };
+
+      std::vector<int32_t> stack;
+      if(m_Root != NullNode) {
+        stack.push_back(m_Root);
+      }
+
+      while(!stack.empty()) {
+        int32_t nodeId = stack.back();
+        const Node& node = m_Nodes[size_t(nodeId)];
+        stack.pop_back();
+
+        float fraction = intersect(node.Bounds);
+        if(fraction < 0.0f) {
+          continue;
+        }
+
+        if(node.IsLeaf()) {
+          callback(nodeId, fraction);
+        } else {
+          stack.push_back(node.Child1);
+          stack.push_back(node.Child2);
+        }
+      }
+    }
+  };
+
+} // end namespace neonGX
+
+#endif // !NEONGX_DYNAMICAABBTREE_H
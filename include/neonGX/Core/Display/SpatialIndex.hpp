@@ -0,0 +1,113 @@
+/*
+ * neonGX - SpatialIndex.hpp
+ *
+ * Copyright (c) 2016, cynecx
+ *
+ * This file is part of neonGX and is distributed under a modified
+ * BSD 3-Clause License. See LICENSE.txt for details.
+ *
+ */
+
+#ifndef NEONGX_SPATIALINDEX_H
+#define NEONGX_SPATIALINDEX_H
+
+#include <neonGX/Core/Math/Primitives.hpp>
+#include <neonGX/Core/Display/DynamicAABBTree.hpp>
+#include <unordered_set>
+#include <vector>
+
+namespace neonGX {
+
+  class Container;
+  class DisplayObject;
+
+  // Dynamic AABB tree over the objects drawn by the subtree of a root
+  // container, see Container::SetSpatialIndexEnabled.
+  //
+  // Objects which draw themselves (sprites, texts, containers cached as
+  // bitmap) are indexed by their cached world bounds. Changed objects are
+  // collected through OnChildChanged and only those get re-indexed by the
+  // next Update. Objects whose bounds are not known yet are reported by
+  // every query until they are.
+  //
+  // Queries are conservative, results may lie slightly outside of the
+  // queried region.
+  class SpatialIndex {
+  private:
+    Container* m_Root;
+    DynamicAABBTree m_Tree;
+
+    // Objects to re-index, deduplicated through their m_SpatialDirtyIndex
+    // instead of a hash set since every moved object lands here.
+    std::vector<DisplayObject*> m_Dirty;
+    std::vector<DisplayObject*> m_Syncing;
+    std::unordered_set<DisplayObject*> m_Unbounded;
+
+    std::vector<DisplayObject*> m_HitCandidates;
+
+    // Set when objects were added or a subtree started or stopped drawing
+    // its children, the draw order of everything gets renumbered by the
+    // next Update.
+    bool m_OrderDirty = true;
+
+    // Whether Update may compute the geometry of objects whose bounds are
+    // unknown, only while their world transforms are current.
+    bool m_ComputeBounds = false;
+
+    static bool IsSelfDrawn(const DisplayObject* object);
+    bool IsDrawn(const DisplayObject* object) const;
+
+    void SyncSubtree(DisplayObject* object, bool parentDrawn);
+    void SyncObject(DisplayObject* object, bool drawn);
+    void RemoveObject(DisplayObject* object);
+    void Unqueue(DisplayObject* object);
+    void RemoveDescendants(DisplayObject* object);
+    void UpdateDrawOrder();
+
+    void Update(bool computeBounds);
+    void Collect(const AABB& bounds,
+                 std::vector<DisplayObject*>& results) const;
+
+  public:
+    explicit SpatialIndex(Container* root);
+    ~SpatialIndex();
+
+    SpatialIndex(const SpatialIndex&) = delete;
+    SpatialIndex& operator=(const SpatialIndex&) = delete;
+
+    void MarkDirty(DisplayObject* object);
+
+    void OnSubtreeAdded(DisplayObject* object);
+    void OnSubtreeRemoved(DisplayObject* object);
+    // The children of object are drawn by it now, or the other way around.
+    void OnRendersChildrenChanged(DisplayObject* object);
+
+    // Re-indexes the objects changed since the last call.
+    void Update();
+
+    void QueryRect(const FRectangle& rect,
+                   std::vector<DisplayObject*>& results);
+    void QueryPoint(const FPoint& point,
+                    std::vector<DisplayObject*>& results);
+
+    // Objects crossed by the segment from -> to, nearest first.
+    void Raycast(const FPoint& from, const FPoint& to,
+                 std::vector<DisplayObject*>& results);
+
+    // Topmost object drawn at the point, candidates are tested in reverse
+    // draw order.
+    DisplayObject* HitTest(const FPoint& point);
+
+    // Objects which may be visible within frame, in draw order. Only
+    // called while rendering.
+    void QueryVisible(const FRectangle& frame,
+                      std::vector<DisplayObject*>& results);
+
+    size_t GetIndexedCount() const {
+      return m_Tree.GetProxyCount();
+    }
+  };
+
+} // end namespace neonGX
+
+#endif // !NEONGX_SPATIALINDEX_H
@@ -38,6 +38,14 @@ namespace neonGX {
     ColorRGB(const ColorRGB&) = default;
     ColorRGB& operator=(const ColorRGB&) = default;
 
+    bool operator==(const ColorRGB& rhs) const {
+      return r == rhs.r && g == rhs.g && b == rhs.b;
+    }
+
+    bool operator!=(const ColorRGB& rhs) const {
+      return !(*this == rhs);
+    }
+
     void AdjustAlpha(float alpha) {
       r = uint8_t(std::round(alpha * r));
       g = uint8_t(std::round(alpha * g));
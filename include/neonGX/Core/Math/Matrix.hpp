@@ -377,6 +377,12 @@ namespace neonGX {
     return { point.x, point.y, 1.0f };
   }
 
+  inline float GetDeterminant(const Matrix3& mat) {
+    return mat[0][0] * (mat[1][1] * mat[2][2] - mat[1][2] * mat[2][1]) -
+           mat[0][1] * (mat[1][0] * mat[2][2] - mat[1][2] * mat[2][0]) +
+           mat[0][2] * (mat[1][0] * mat[2][1] - mat[1][1] * mat[2][0]);
+  }
+
   inline Matrix3 GetInverseMatrix(const Matrix3& mat) {
     float a = mat[0][0];
     float b = mat[0][1];
@@ -390,18 +396,23 @@ namespace neonGX {
     float h = mat[2][1];
     float i = mat[2][2];
 
-    // Sauce: Wolfram Alpha
+    // Cofactors of the first column, reused for the determinant.
+    float ei = e*i-f*h;
+    float fg = f*g-d*i;
+    float dh = d*h-e*g;
+
+    float invDet = 1.0f / (a*ei + b*fg + c*dh);
 
     return {
-        (e*i-f*h) / (-c*e*g+b*f*g+c*d*h-a*f*h-b*d*i+a*e*i),
-        (c*h-b*i) / (-c*e*g+b*f*g+c*d*h-a*f*h-b*d*i+a*e*i),
-        (b*f-c*e) / (-c*e*g+b*f*g+c*d*h-a*f*h-b*d*i+a*e*i),
-        (f*g-d*i) / (-c*e*g+b*f*g+c*d*h-a*f*h-b*d*i+a*e*i),
-        (a*i-c*g) / (-c*e*g+b*f*g+c*d*h-a*f*h-b*d*i+a*e*i),
-        (c*d-a*f) / (-c*e*g+b*f*g+c*d*h-a*f*h-b*d*i+a*e*i),
-        (d*h-e*g) / (-c*e*g+b*f*g+c*d*h-a*f*h-b*d*i+a*e*i),
-        (b*g-a*h) / (-c*e*g+b*f*g+c*d*h-a*f*h-b*d*i+a*e*i),
-        (a*e-b*d) / (-c*e*g+b*f*g+c*d*h-a*f*h-b*d*i+a*e*i),
+        ei * invDet,
+        (c*h-b*i) * invDet,
+        (b*f-c*e) * invDet,
+        fg * invDet,
+        (a*i-c*g) * invDet,
+        (c*d-a*f) * invDet,
+        dh * invDet,
+        (b*g-a*h) * invDet,
+        (a*e-b*d) * invDet,
     };
   }
 
@@ -407,6 +407,16 @@ namespace neonGX {
   using NRectangle = RectangleImpl<int32_t, int32_t>;
   using FRectangle = RectangleImpl<float, float>;
 
+  // Smallest integer rectangle enclosing the given float extents.
+  inline NRectangle RoundOutBounds(float minX, float minY,
+                                   float maxX, float maxY) {
+    int32_t x0 = int32_t(std::floor(minX));
+    int32_t y0 = int32_t(std::floor(minY));
+    int32_t x1 = int32_t(std::ceil(maxX));
+    int32_t y1 = int32_t(std::ceil(maxY));
+    return { {x0, y0}, {x1 - x0, y1 - y0} };
+  }
+
 } // end namespace neonGX
 
 #endif // !NEONGX_PRIMITIVES_H
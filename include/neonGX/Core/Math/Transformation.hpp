@@ -14,6 +14,7 @@
 #include <cmath>
 #include <neonGX/Core/Math/Primitives.hpp>
 #include <neonGX/Core/Math/Matrix.hpp>
+#include <neonGX/Core/Math/Affine2D.hpp>
 #include <boost/math/constants/constants.hpp>
 
 //#define USE_CONSTANT_CACHING
@@ -99,6 +100,56 @@ namespace neonGX {
     return GetSkewingMatrix(point.x, point.y);
   }
 
+  // Closed form of GetSkewingMatrix(skew) * GetTranslationMatrix(position) *
+  // GetTranslationMatrix(pivot) * GetRotationMatrix(rotation) *
+  // GetScalingMatrix(scale) * GetTranslationMatrix(-pivot).
+  inline Affine2D GetLocalTransform(const FPoint& position,
+                                    const FPoint& scale,
+                                    const FPoint& pivot,
+                                    const FPoint& skew,
+                                    float rotation) {
+    float qsin = 0.0f;
+    float qcos = 1.0f;
+    if(rotation != 0.0f) {
+#ifdef USE_CONSTANT_CACHING
+      qsin = ConstantCache(ConstantCacheType::sin, rotation);
+      qcos = ConstantCache(ConstantCacheType::cos, rotation);
+#else
+      qsin = sin(rotation);
+      qcos = cos(rotation);
+#endif
+    }
+
+    float a = qcos * scale.x;
+    float b = -qsin * scale.y;
+    float c = qsin * scale.x;
+    float d = qcos * scale.y;
+
+    // Rotation and scaling happen around the pivot.
+    float tx = position.x + pivot.x - (a * pivot.x + b * pivot.y);
+    float ty = position.y + pivot.y - (c * pivot.x + d * pivot.y);
+
+    if(skew.x == 0.0f && skew.y == 0.0f) {
+      return {
+          a, b, tx,
+          c, d, ty
+      };
+    }
+
+#ifdef USE_CONSTANT_CACHING
+    float xtan = ConstantCache(ConstantCacheType::tan, skew.x);
+    float ytan = ConstantCache(ConstantCacheType::tan, skew.y);
+#else
+    float xtan = tan(skew.x);
+    float ytan = tan(skew.y);
+#endif
+
+    return {
+        a + xtan * c, b + xtan * d, tx + xtan * ty,
+        ytan * a + c, ytan * b + d, ytan * tx + ty
+    };
+  }
+
   inline constexpr Matrix3 GetIdentityTransform() {
     return {
         1.0f, 0.0f, 0.0f,
@@ -107,18 +158,18 @@ namespace neonGX {
     };
   }
 
-  inline Matrix3 GetToClipspaceTransform(const FSize& destFrame,
-                                         const FPoint& sourcePoint,
-                                         bool swapHeightSign) {
+  inline Affine2D GetToClipspaceTransform(const FSize& destFrame,
+                                          const FPoint& sourcePoint,
+                                          bool swapHeightSign) {
     // (Position / Resolution) * 2 - 1
-    auto toClipspace = Matrix3{
+    auto toClipspace = Affine2D{
         2.0f / destFrame.width, 0.0f, -1.0f,
         0.0f, (swapHeightSign ? -2.0f : 2.0f) / destFrame.height,
-          (swapHeightSign ? 1.0f : -1.0f),
-        0.0f, 0.0f, 1.0f
+          (swapHeightSign ? 1.0f : -1.0f)
     };
 
-    return toClipspace * GetTranslationMatrix(-sourcePoint.x, -sourcePoint.y);
+    return toClipspace *
+        Affine2D::Translation(-sourcePoint.x, -sourcePoint.y);
   }
 
 } // end namespace neonGX
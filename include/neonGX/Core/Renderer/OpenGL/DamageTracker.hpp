@@ -0,0 +1,90 @@
+/*
+ * neonGX - DamageTracker.hpp
+ *
+ * Copyright (c) 2016, cynecx
+ *
+ * This file is part of neonGX and is distributed under a modified
+ * BSD 3-Clause License. See LICENSE.txt for details.
+ *
+ */
+
+#ifndef NEONGX_DAMAGETRACKER_H
+#define NEONGX_DAMAGETRACKER_H
+
+#include <neonGX/Core/Math/Primitives.hpp>
+#include <neonGX/Core/Math/Affine2D.hpp>
+#include <cassert>
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+namespace neonGX {
+
+  class DisplayObject;
+
+  // Collects the world space regions of the canvas which changed between
+  // two frames.
+  //
+  // Every drawn object is tracked with its bounds, world transform and
+  // world alpha. An object is damaged when it reports a change of its own,
+  // when any of those differ from the previous frame, or when it is no
+  // longer drawn at all. Both its old and its new bounds get redrawn.
+  class DamageTracker {
+  public:
+    // Damaged regions are merged until no more than this many are left.
+    static constexpr size_t MaxRects = 4;
+
+    // Oldest back buffer contents which are repaired instead of redrawn.
+    static constexpr size_t MaxBufferAge = 4;
+
+  private:
+    struct Entry {
+      NRectangle Bounds;
+      Affine2D Transform;
+      float Alpha;
+    };
+
+    std::unordered_map<const DisplayObject*, Entry> m_Previous;
+    std::unordered_map<const DisplayObject*, Entry> m_Current;
+
+    std::vector<NRectangle> m_FrameRects;
+    std::vector<NRectangle> m_Rects;
+
+    // Damage of the last MaxBufferAge - 1 presented frames, newest first.
+    std::vector<std::vector<NRectangle>> m_History;
+
+    // Number of frames ago the back buffer was presented, 1 for preserved
+    // drawing buffers. 0 means its contents are undefined and every frame
+    // is redrawn as a whole.
+    size_t m_BufferAge = 0;
+    bool m_FullDamage = true;
+
+    void AddRect(std::vector<NRectangle>& rects, NRectangle rect);
+
+  public:
+    // Age of the buffer the next frame is drawn into, see m_BufferAge.
+    void SetBufferAge(size_t bufferAge) {
+      m_BufferAge = bufferAge;
+    }
+
+    // The whole canvas gets redrawn with the next frame.
+    void Invalidate() {
+      m_FullDamage = true;
+    }
+
+    void Track(const DisplayObject* object, const NRectangle& bounds,
+               const Affine2D& worldTransform, float worldAlpha,
+               bool changed);
+
+    // Computes the regions to redraw from the objects tracked since the
+    // last call. Nothing needs to be drawn if none are left.
+    void EndFrame(const NRectangle& viewport);
+
+    const std::vector<NRectangle>& GetRects() const {
+      return m_Rects;
+    }
+  };
+
+} // end namespace neonGX
+
+#endif // !NEONGX_DAMAGETRACKER_H
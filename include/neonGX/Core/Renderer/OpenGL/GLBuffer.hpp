@@ -15,9 +15,12 @@
 #include <neonGX/Core/Math/Primitives.hpp>
 #include <neonGX/Core/Graphics/Color.hpp>
 #include <neonGX/Core/Renderer/OpenGL/GLContext.hpp>
+#include <neonGX/Core/Renderer/OpenGL/GLStateCache.hpp>
 #include <vector>
 #include <GSL/span.h>
 #include <memory>
+#include <cassert>
+#include <cstddef>
 
 namespace neonGX {
 
@@ -28,6 +31,10 @@ namespace neonGX {
     int m_Type;
     int m_DrawType;
 
+    // Size of the data store and the append cursor used by StreamData.
+    size_t m_Capacity = 0;
+    size_t m_WriteOffset = 0;
+
     bool m_Moved = false;
 
   public:
@@ -48,11 +55,16 @@ namespace neonGX {
 
     GLBuffer(GLBuffer&& obj)
         : m_GLHandle(obj.m_GLHandle), m_Buffer(obj.m_Buffer),
-          m_Type(obj.m_Type), m_DrawType(obj.m_DrawType) {
+          m_Type(obj.m_Type), m_DrawType(obj.m_DrawType),
+          m_Capacity(obj.m_Capacity), m_WriteOffset(obj.m_WriteOffset) {
       obj.m_Moved = true;
     }
 
     GLBuffer& operator=(GLBuffer&& obj) {
+      if(auto* stateCache = GLStateCache::ForContext(m_GLHandle)) {
+        stateCache->OnDeleteBuffer(m_Buffer);
+      }
+
       WebGLContextRAII switchCtx(m_GLHandle);
 
       GLuint tmpBArr[1] = { m_Buffer };
@@ -62,6 +74,8 @@ namespace neonGX {
       m_Buffer = obj.m_Buffer;
       m_Type = obj.m_Type;
       m_DrawType = obj.m_DrawType;
+      m_Capacity = obj.m_Capacity;
+      m_WriteOffset = obj.m_WriteOffset;
 
       obj.m_Moved = true;
 
@@ -73,6 +87,10 @@ namespace neonGX {
         return;
       }
 
+      if(auto* stateCache = GLStateCache::ForContext(m_GLHandle)) {
+        stateCache->OnDeleteBuffer(m_Buffer);
+      }
+
       WebGLContextRAII switchCtx(m_GLHandle);
 
       GLuint tmpBArr[1] = { m_Buffer };
@@ -87,23 +105,69 @@ namespace neonGX {
       WebGLContextRAII switchCtx(m_GLHandle);
       glBufferData(m_Type, GLsizeiptr(data.size_bytes()), data.data(),
           m_DrawType);
+
+      m_Capacity = size_t(data.size_bytes());
+      m_WriteOffset = 0;
     }
 
-    void UploadSubData(gsl::span<const uint8_t> data, bool dontBind = false) {
+    void UploadSubData(gsl::span<const uint8_t> data, bool dontBind = false,
+                       size_t offset = 0) {
       if(!dontBind) {
         Bind();
       }
 
+      assert(offset + size_t(data.size_bytes()) <= m_Capacity);
+
       WebGLContextRAII switchCtx(m_GLHandle);
-      glBufferSubData(m_Type, 0, GLsizeiptr(data.size_bytes()), data.data());
+      glBufferSubData(m_Type, GLintptr(offset), GLsizeiptr(data.size_bytes()),
+          data.data());
+    }
+
+    // Appends data behind the previous upload and returns its byte offset.
+    // Once the store is exhausted it gets orphaned, the driver then hands
+    // out fresh memory instead of waiting for pending draws to finish
+    // reading the old one.
+    size_t StreamData(gsl::span<const uint8_t> data, bool dontBind = false) {
+      if(!dontBind) {
+        Bind();
+      }
+
+      size_t size = size_t(data.size_bytes());
+      assert(size <= m_Capacity);
+
+      WebGLContextRAII switchCtx(m_GLHandle);
+
+      if(m_WriteOffset + size > m_Capacity) {
+        glBufferData(m_Type, GLsizeiptr(m_Capacity), nullptr, m_DrawType);
+        m_WriteOffset = 0;
+      }
+
+      size_t offset = m_WriteOffset;
+      glBufferSubData(m_Type, GLintptr(offset), GLsizeiptr(size),
+          data.data());
+
+      // Keep every upload 4 byte aligned as required for vertex attributes.
+      m_WriteOffset = (offset + size + 3) & ~size_t(3);
+
+      return offset;
     }
 
     void Bind() {
+      if(auto* stateCache = GLStateCache::ForContext(m_GLHandle)) {
+        stateCache->BindBuffer(GLenum(m_Type), m_Buffer);
+        return;
+      }
+
       WebGLContextRAII switchCtx(m_GLHandle);
       glBindBuffer(m_Type, m_Buffer);
     }
 
     void Unbind() {
+      if(auto* stateCache = GLStateCache::ForContext(m_GLHandle)) {
+        stateCache->BindBuffer(GLenum(m_Type), 0);
+        return;
+      }
+
       WebGLContextRAII switchCtx(m_GLHandle);
       glBindBuffer(m_Type, 0);
     }
@@ -120,6 +184,22 @@ namespace neonGX {
       return buffer;
     }
 
+    static std::unique_ptr<GLBuffer> CreateStreamingVertexBuffer(
+        webgl_context_handle glHandle, size_t capacity) {
+
+      std::unique_ptr<GLBuffer> buffer = std::make_unique<GLBuffer>(
+          glHandle, GL_ARRAY_BUFFER, GL_STREAM_DRAW);
+
+      buffer->Bind();
+
+      WebGLContextRAII switchCtx(glHandle);
+      glBufferData(GL_ARRAY_BUFFER, GLsizeiptr(capacity), nullptr,
+          GL_STREAM_DRAW);
+      buffer->m_Capacity = capacity;
+
+      return buffer;
+    }
+
     static std::unique_ptr<GLBuffer> CreateIndexBuffer(
         webgl_context_handle glHandle, gsl::span<const uint8_t> data,
         int drawType) {
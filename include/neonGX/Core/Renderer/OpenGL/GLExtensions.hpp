@@ -0,0 +1,63 @@
+/*
+ * neonGX - GLExtensions.hpp
+ *
+ * Copyright (c) 2016, cynecx
+ *
+ * This file is part of neonGX and is distributed under a modified
+ * BSD 3-Clause License. See LICENSE.txt for details.
+ *
+ */
+
+#ifndef NEONGX_GLEXTENSIONS_H
+#define NEONGX_GLEXTENSIONS_H
+
+#include <neonGX/Core/Renderer/OpenGL/GLContext.hpp>
+#include <cstddef>
+
+namespace neonGX {
+
+  // Optional functionality beyond GLES2/WebGL1, resolved once per context.
+  class GLExtensions {
+  private:
+    webgl_context_handle m_GLHandle = invalid_context_handle;
+
+    // ANGLE_instanced_arrays on WebGL1, core since GL 3.3/GLES3.
+    bool m_InstancedArrays = false;
+
+    // OES_standard_derivatives on WebGL1, core in desktop GLSL.
+    bool m_StandardDerivatives = false;
+
+    // GLX_EXT_buffer_age on desktops.
+    bool m_BufferAge = false;
+
+#ifndef NEONGX_USE_EMSCRIPTEN
+    PFNGLDRAWELEMENTSINSTANCEDPROC m_DrawElementsInstanced = nullptr;
+    PFNGLVERTEXATTRIBDIVISORPROC m_VertexAttribDivisor = nullptr;
+#endif
+
+  public:
+    GLExtensions() = default;
+    explicit GLExtensions(webgl_context_handle glHandle);
+
+    bool HasInstancedArrays() const {
+      return m_InstancedArrays;
+    }
+
+    bool HasStandardDerivatives() const {
+      return m_StandardDerivatives;
+    }
+
+    // Number of frames ago the contents of the current back buffer were
+    // presented, 0 if they are undefined. Only GLX_EXT_buffer_age reports
+    // an age on desktops, WebGL is never asked since a preserved drawing
+    // buffer always has age 1.
+    size_t GetBufferAge() const;
+
+    void DrawElementsInstanced(GLenum mode, GLsizei count, GLenum type,
+                               const void* indices, GLsizei instances) const;
+    void VertexAttribDivisor(GLuint index, GLuint divisor) const;
+  };
+
+} // end namespace neonGX
+
+#endif // !NEONGX_GLEXTENSIONS_H
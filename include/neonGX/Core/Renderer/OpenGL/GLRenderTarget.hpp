@@ -12,11 +12,12 @@
 #define NEONGX_GLRENDERTARGET_H
 
 #include <neonGX/Core/Math/Primitives.hpp>
-#include <neonGX/Core/Math/Matrix.hpp>
+#include <neonGX/Core/Math/Affine2D.hpp>
 #include <neonGX/Core/Math/Helpers.hpp>
 #include <neonGX/Core/Math/Transformation.hpp>
 #include <neonGX/Core/Renderer/OpenGL/GLContext.hpp>
 #include <neonGX/Core/Renderer/OpenGL/GLFrameBuffer.hpp>
+#include <neonGX/Core/Renderer/OpenGL/GLStateCache.hpp>
 #include <neonGX/Core/Renderer/OpenGL/GLTexture.hpp>
 #include <neonGX/Core/Textures/BaseTexture.hpp>
 #include <neonGX/Core/Textures/Texture.hpp>
@@ -32,8 +33,8 @@ namespace neonGX {
     FRectangle m_Size{ {0, 0}, {1, 1} };
     float m_Resolution;
 
-    Matrix3 m_ProjectionMatrix;
-    optional<Matrix3> m_TransformMatrix;
+    Affine2D m_ProjectionMatrix;
+    optional<Affine2D> m_TransformMatrix;
 
     ScaleMode m_ScaleMode;
     bool m_Root;
@@ -48,8 +49,9 @@ namespace neonGX {
       WebGLContextRAII switchCtx(glHandle);
 
       if(!m_Root) {
-        m_FrameBuffer = GLFrameBuffer::CreateRGBA(
-            glHandle, FSize{100.0f, 100.0f}, m_ScaleMode);
+        m_FrameBuffer = GLFrameBuffer::CreateRGBA(glHandle,
+            FSize{size.width * resolution, size.height * resolution},
+            m_ScaleMode);
       }
 
       Resize(size);
@@ -71,6 +73,8 @@ namespace neonGX {
 
       if(m_FrameBuffer) {
         m_FrameBuffer->Bind();
+      } else {
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
       }
 
       CalculateProjection(m_Size, nullopt);
@@ -79,11 +83,16 @@ namespace neonGX {
         m_ProjectionMatrix *= m_TransformMatrix.value();
       }
 
-      glViewport(
-          GLint(m_Size.point.x),
-          GLint(m_Size.point.y),
-          GLint(m_Size.size.width * m_Resolution),
-          GLint(m_Size.size.height * m_Resolution));
+      GLint x = GLint(m_Size.point.x);
+      GLint y = GLint(m_Size.point.y);
+      GLint width = GLint(m_Size.size.width * m_Resolution);
+      GLint height = GLint(m_Size.size.height * m_Resolution);
+
+      if(auto* stateCache = GLStateCache::ForContext(m_GLHandle)) {
+        stateCache->Viewport(x, y, width, height);
+      } else {
+        glViewport(x, y, width, height);
+      }
     }
 
     void CalculateProjection(const FRectangle& destFrame,
@@ -13,11 +13,17 @@
 
 #include <neonGX/Core/Renderer/Renderer.hpp>
 #include <neonGX/Core/Renderer/OpenGL/GLContext.hpp>
+#include <neonGX/Core/Renderer/OpenGL/DamageTracker.hpp>
 #include <neonGX/Core/Renderer/OpenGL/GLRenderTarget.hpp>
+#include <neonGX/Core/Renderer/OpenGL/GLStateCache.hpp>
+#include <neonGX/Core/Renderer/OpenGL/GLExtensions.hpp>
 #include <neonGX/Core/Renderer/OpenGL/ObjectRenderer.hpp>
+#include <neonGX/Core/Renderer/OpenGL/RenderCommandQueue.hpp>
 #include <neonGX/Core/Renderer/OpenGL/Managers/ShaderManager.hpp>
 #include <neonGX/Core/Text/FontTextureManager.hpp>
+#include <neonGX/Core/Threading/WorkerPool.hpp>
 #include <neonGX/Core/Display/DisplayObject.hpp>
+#include <chrono>
 #include <string>
 #include <memory>
 
@@ -25,11 +31,40 @@ namespace neonGX {
 
   class SpriteRenderer;
   class TextRenderer;
-
-  enum class ObjectRendererType {
-    None,
-    Sprite,
-    Text
+  class RenderThread;
+  class RenderTexture;
+  struct RenderSnapshot;
+
+  // Counters of the last GLRenderer::Render call.
+  struct GLRendererStats {
+    size_t DrawCalls = 0;
+    size_t Flushes = 0;
+    size_t Sprites = 0;
+
+    // Sprites which were moved by the batch reorder pass and the draw calls
+    // it saved compared to painter's order.
+    size_t ReorderedSprites = 0;
+    size_t ReorderSavedDrawCalls = 0;
+
+    // GL state changes issued and the redundant ones GLStateCache dropped.
+    size_t StateChanges = 0;
+    size_t SkippedStateChanges = 0;
+
+    // Render commands emitted by the traversal and the time, in
+    // milliseconds, spent traversing, sorting and submitting them.
+    size_t Commands = 0;
+    float TraversalTime = 0.0f;
+    float SortTime = 0.0f;
+    float SubmissionTime = 0.0f;
+
+    // RendererSettings::PartialRedraw only, regions redrawn by the frame.
+    // None if the frame was skipped.
+    size_t DamageRects = 0;
+    bool SkippedFrame = false;
+
+    // Display objects skipped for being outside of the render target, a
+    // culled container counts once.
+    size_t CulledObjects = 0;
   };
 
   class GLRenderer final : public Renderer {
@@ -42,16 +77,58 @@ namespace neonGX {
     friend class Sprite;
     friend class TextRenderer;
     friend class Text;
+    friend class RenderThread;
 
+    std::unique_ptr<GLStateCache> m_StateCache;
+    GLExtensions m_Extensions;
     std::unique_ptr<GLRenderTarget> m_RenderTarget;
+    // The target the object renderers draw into, m_RenderTarget unless
+    // RenderToTexture is in progress.
+    GLRenderTarget* m_CurrentRenderTarget = nullptr;
     std::unique_ptr<ShaderManager> m_ShaderManager;
     std::unique_ptr<TextRenderer> m_TextRenderer;
     std::unique_ptr<SpriteRenderer> m_SpriteRenderer;
     std::shared_ptr<FontTextureManager> m_FontTextureManager;
 
+    RenderCommandQueue m_CommandQueue;
+    std::unique_ptr<WorkerPool> m_BatchWorkers;
+
+    // World space region covered by the active render target, nullopt
+    // while it is not known and nothing may be culled.
+    optional<FRectangle> m_CullingFrame;
+    size_t m_CulledObjects = 0;
+
+    DamageTracker m_DamageTracker;
+    // World bounds of each sorted render command while redrawing damage.
+    std::vector<NRectangle> m_CommandBounds;
+
     ObjectRendererType m_CurrentRendererType = ObjectRendererType::None;
     ObjectRenderer* m_CurrentRenderer = nullptr;
 
+    GLRendererStats m_Stats;
+
+    // Set by RendererSettings::UseRenderThread, owns the GL context from
+    // then on. m_Stats belongs to the render thread, the game thread reads
+    // the stats of the last drawn frame from m_PresentedStats.
+    std::unique_ptr<RenderThread> m_RenderThread;
+    GLRendererStats m_PresentedStats;
+
+    // Render commands per job of the parallel sprite vertex pass.
+    static constexpr size_t SpriteVertexGrain = 512;
+
+    void UpdateSpriteVertices();
+
+    void BuildCommandQueue(DisplayObject* object, GLRendererStats& stats);
+    void CaptureSnapshot(RenderSnapshot& snapshot);
+    void DrawSnapshot(const RenderSnapshot& snapshot);
+
+    void TrackDamage();
+    void SubmitDamagedRegions();
+
+    void ClearTarget();
+    std::chrono::steady_clock::time_point BeginSubmission();
+    void EndSubmission(std::chrono::steady_clock::time_point submissionStart);
+
   public:
     explicit GLRenderer(const std::string& target, const FSize& size,
                         const RendererSettings& settings);
@@ -63,7 +140,58 @@ namespace neonGX {
 
     ObjectRenderer* SetObjectRenderer(ObjectRendererType type);
 
+    // Queues the object for the submission pass of the current Render
+    // call. Shader and texture only group commands on sortable layers.
+    void SubmitRenderCommand(ObjectRendererType type, DisplayObject* object,
+                             uint8_t shader = 0, uint32_t texture = 0) {
+      m_CommandQueue.Push(object->GetRenderLayer(), type, shader, texture,
+          object);
+    }
+
+    const optional<FRectangle>& GetCullingFrame() const {
+      return m_CullingFrame;
+    }
+
+    // True if the cached world bounds of the object are known and miss the
+    // active render target, the object is not drawn then.
+    bool CullObject(DisplayObject& object);
+
+    // Draws the object into the texture right away, independent of the
+    // frame being rendered. The texture is resized to the drawn region, by
+    // default the world space bounds of the object, which is returned.
+    FRectangle RenderToTexture(DisplayObject* object, RenderTexture& texture,
+                               optional<FRectangle> region = nullopt);
+
+    // False after the last Render call skipped its frame for lack of
+    // damage, the previously presented frame is still valid then.
+    bool HasNewFrame() const {
+      return !m_Stats.SkippedFrame;
+    }
+
+    // The GL context is owned by a render thread otherwise.
+    bool CanRenderToTexture() const {
+      return !m_RenderThread;
+    }
+
+    // Frames are swapped by the render thread, the main loop must not.
+    bool PresentsOnRenderThread() const {
+      return bool(m_RenderThread);
+    }
+
+    RenderCommandQueue& GetCommandQueue() {
+      return m_CommandQueue;
+    }
+
+    // Null unless RendererSettings::BatchWorkerThreads is set.
+    WorkerPool* GetBatchWorkers() {
+      return m_BatchWorkers.get();
+    }
+
     std::shared_ptr<FontTextureManager> GetFontTextureManager();
+
+    const GLRendererStats& GetStats() const {
+      return m_RenderThread ? m_PresentedStats : m_Stats;
+    }
   };
 
 } // end namespace neonGX
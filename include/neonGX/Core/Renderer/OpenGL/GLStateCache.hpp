@@ -0,0 +1,89 @@
+/*
+ * neonGX - GLStateCache.hpp
+ *
+ * Copyright (c) 2016, cynecx
+ *
+ * This file is part of neonGX and is distributed under a modified
+ * BSD 3-Clause License. See LICENSE.txt for details.
+ *
+ */
+
+#ifndef NEONGX_GLSTATECACHE_H
+#define NEONGX_GLSTATECACHE_H
+
+#include <neonGX/Core/Renderer/OpenGL/GLContext.hpp>
+#include <neonGX/Core/ADT.hpp>
+#include <array>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+namespace neonGX {
+
+  // Shadows the binding state of a single GL context, state changes which
+  // wouldn't change anything are dropped before they reach GL (and before a
+  // WebGLContextRAII has to be constructed for them).
+  class GLStateCache {
+  private:
+    static constexpr GLuint UnknownObject = std::numeric_limits<GLuint>::max();
+    static constexpr GLenum UnknownEnum = std::numeric_limits<GLenum>::max();
+    static constexpr GLint UnknownInt = std::numeric_limits<GLint>::min();
+
+    webgl_context_handle m_GLHandle;
+
+    GLuint m_Program;
+    GLuint m_ArrayBuffer;
+    GLuint m_ElementBuffer;
+
+    size_t m_ActiveUnit;
+    std::vector<GLuint> m_Textures;
+
+    GLenum m_BlendSrc;
+    GLenum m_BlendDst;
+
+    std::array<GLint, 4> m_Viewport;
+
+    size_t m_IssuedCalls = 0;
+    size_t m_SkippedCalls = 0;
+
+  public:
+    explicit GLStateCache(webgl_context_handle glHandle);
+    ~GLStateCache();
+
+    GLStateCache(const GLStateCache&) = delete;
+    GLStateCache& operator=(const GLStateCache&) = delete;
+
+    // Returns the cache of the context or nullptr if no renderer owns it.
+    static GLStateCache* ForContext(webgl_context_handle glHandle);
+
+    // Forgets everything, used whenever GL is touched behind the cache.
+    void Invalidate();
+
+    void UseProgram(GLuint program);
+    void BindBuffer(GLenum target, GLuint buffer);
+    void ActiveTexture(size_t unit);
+    void BindTexture(optional<size_t> unit, GLuint texture);
+    void BlendFunc(GLenum src, GLenum dst);
+    void Viewport(GLint x, GLint y, GLint width, GLint height);
+
+    // Deleted objects are implicitly unbound by GL.
+    void OnDeleteBuffer(GLuint buffer);
+    void OnDeleteTexture(GLuint texture);
+
+    size_t GetIssuedCalls() const {
+      return m_IssuedCalls;
+    }
+
+    size_t GetSkippedCalls() const {
+      return m_SkippedCalls;
+    }
+
+    void ResetCounters() {
+      m_IssuedCalls = 0;
+      m_SkippedCalls = 0;
+    }
+  };
+
+} // end namespace neonGX
+
+#endif // !NEONGX_GLSTATECACHE_H
@@ -14,6 +14,7 @@
 #include <neonGX/Core/Math/Primitives.hpp>
 #include <neonGX/Core/Graphics/Color.hpp>
 #include <neonGX/Core/Renderer/OpenGL/GLContext.hpp>
+#include <neonGX/Core/Renderer/OpenGL/GLStateCache.hpp>
 #include <neonGX/Core/Image/PNGImage.hpp>
 #include <neonGX/Core/ADT.hpp>
 #include <GSL/span.h>
@@ -50,6 +51,10 @@ namespace neonGX {
     }
 
     GLTexture& operator=(GLTexture&& obj) {
+      if(auto* stateCache = GLStateCache::ForContext(m_GLHandle)) {
+        stateCache->OnDeleteTexture(m_Texture);
+      }
+
       WebGLContextRAII switchCtx(m_GLHandle);
 
       GLuint tmpTexArr[1] = { m_Texture };
@@ -73,6 +78,8 @@ namespace neonGX {
 
     void UploadImage(const PNGImage& image);
     void UploadData(gsl::span<const uint8_t> data, optional<FSize> size);
+    void UploadSubData(gsl::span<const uint8_t> data,
+                       const NRectangle& region);
 
     FSize GetSize() const;
 
@@ -13,7 +13,10 @@
 
 #include <neonGX/Core/Renderer/OpenGL/GLContext.hpp>
 #include <neonGX/Core/Renderer/OpenGL/Shaders/TextureShader.hpp>
+#include <neonGX/Core/Renderer/OpenGL/Shaders/InstancedTextureShader.hpp>
 #include <neonGX/Core/Renderer/OpenGL/Shaders/FontTextureShader.hpp>
+#include <neonGX/Core/Renderer/OpenGL/Shaders/SDFFontTextureShader.hpp>
+#include <algorithm>
 #include <memory>
 #include <unordered_set>
 
@@ -22,14 +25,18 @@ namespace neonGX {
   enum class ShaderType {
     None,
     TextureShader,
-    FontTextureShader
+    InstancedTextureShader,
+    FontTextureShader,
+    SDFFontTextureShader
   };
 
   class ShaderManager {
   private:
     webgl_context_handle m_GlHandle;
     std::unique_ptr<TextureShader> m_TextureShader;
+    std::unique_ptr<InstancedTextureShader> m_InstancedTextureShader;
     std::unique_ptr<FontTextureShader> m_FontTextureShader;
+    std::unique_ptr<SDFFontTextureShader> m_SDFFontTextureShader;
     ShaderType m_CurrentShader = ShaderType::None;
     std::unordered_set<GLuint> m_ActivatedShaderAttributes;
 
@@ -43,11 +50,29 @@ namespace neonGX {
       return m_CurrentShader;
     }
 
-    void InitializeTextureShader() {
+    size_t GetMaxTextureUnits() const {
+      WebGLContextRAII switchCtx(m_GlHandle);
+
+      GLint maxTextureUnits = 0;
+      glGetIntegerv(GL_MAX_TEXTURE_IMAGE_UNITS, &maxTextureUnits);
+
+      return size_t(std::max<GLint>(maxTextureUnits, 1));
+    }
+
+    void InitializeTextureShader(size_t textureCount = 1) {
       if(m_TextureShader) {
         return;
       }
-      m_TextureShader = std::make_unique<TextureShader>(m_GlHandle, this);
+      m_TextureShader = std::make_unique<TextureShader>(
+          m_GlHandle, this, textureCount);
+    }
+
+    void InitializeInstancedTextureShader(size_t textureCount = 1) {
+      if(m_InstancedTextureShader) {
+        return;
+      }
+      m_InstancedTextureShader = std::make_unique<InstancedTextureShader>(
+          m_GlHandle, this, textureCount);
     }
 
     void InitializeFontTextureShader() {
@@ -58,6 +83,14 @@ namespace neonGX {
           m_GlHandle, this);
     }
 
+    void InitializeSDFFontTextureShader(bool standardDerivatives = false) {
+      if(m_SDFFontTextureShader) {
+        return;
+      }
+      m_SDFFontTextureShader = std::make_unique<SDFFontTextureShader>(
+          m_GlHandle, this, standardDerivatives);
+    }
+
     void ActivateShaderAttributes() {
       GLShader* shader = nullptr;
 
@@ -65,14 +98,40 @@ namespace neonGX {
         case ShaderType::TextureShader:
           shader = m_TextureShader.get();
           break;
+        case ShaderType::InstancedTextureShader:
+          shader = m_InstancedTextureShader.get();
+          break;
         case ShaderType::FontTextureShader:
           shader = m_FontTextureShader.get();
           break;
+        case ShaderType::SDFFontTextureShader:
+          shader = m_SDFFontTextureShader.get();
+          break;
         default:
           assert("Invalid shader." && false);
           break;
       }
 
+      WebGLContextRAII switchCtx(m_GlHandle);
+
+      // Arrays enabled for a previous shader would still be validated by
+      // every draw call, even though nothing reads them.
+      for(auto it = m_ActivatedShaderAttributes.begin();
+          it != m_ActivatedShaderAttributes.end();) {
+        auto location = *it;
+        auto used = std::find_if(shader->m_shaderAttributes.begin(),
+            shader->m_shaderAttributes.end(), [location] (const auto& attrib) {
+              return attrib.second.Location == location;
+            });
+
+        if(used == shader->m_shaderAttributes.end()) {
+          glDisableVertexAttribArray(location);
+          it = m_ActivatedShaderAttributes.erase(it);
+        } else {
+          ++it;
+        }
+      }
+
       for(auto& it : shader->m_shaderAttributes) {
         auto attribState = m_ActivatedShaderAttributes.find(it.second.Location);
         if(attribState == m_ActivatedShaderAttributes.end()) {
@@ -93,6 +152,28 @@ namespace neonGX {
       return *m_FontTextureShader;
     }
 
+    SDFFontTextureShader& UseSDFFontTextureShader() {
+      if(m_CurrentShader != ShaderType::SDFFontTextureShader) {
+        InitializeSDFFontTextureShader();
+
+        m_CurrentShader = ShaderType::SDFFontTextureShader;
+        m_SDFFontTextureShader->Bind();
+      }
+
+      return *m_SDFFontTextureShader;
+    }
+
+    InstancedTextureShader& UseInstancedTextureShader() {
+      if(m_CurrentShader != ShaderType::InstancedTextureShader) {
+        InitializeInstancedTextureShader();
+
+        m_CurrentShader = ShaderType::InstancedTextureShader;
+        m_InstancedTextureShader->Bind();
+      }
+
+      return *m_InstancedTextureShader;
+    }
+
     TextureShader& UseTextureShader() {
       if(m_CurrentShader != ShaderType::TextureShader) {
         InitializeTextureShader();
@@ -15,6 +15,12 @@
 
 namespace neonGX {
 
+  enum class ObjectRendererType {
+    None,
+    Sprite,
+    Text
+  };
+
   struct ObjectRenderer {
     ObjectRenderer();
     virtual ~ObjectRenderer();
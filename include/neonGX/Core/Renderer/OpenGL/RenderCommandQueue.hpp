@@ -0,0 +1,93 @@
+/*
+ * neonGX - RenderCommandQueue.hpp
+ *
+ * Copyright (c) 2016, cynecx
+ *
+ * This file is part of neonGX and is distributed under a modified
+ * BSD 3-Clause License. See LICENSE.txt for details.
+ *
+ */
+
+#ifndef NEONGX_RENDERCOMMANDQUEUE_H
+#define NEONGX_RENDERCOMMANDQUEUE_H
+
+#include <neonGX/Core/Renderer/OpenGL/ObjectRenderer.hpp>
+#include <bitset>
+#include <cstdint>
+#include <vector>
+
+namespace neonGX {
+
+  class DisplayObject;
+
+  struct RenderCommand {
+    uint64_t SortKey;
+    DisplayObject* Object;
+    ObjectRendererType Renderer;
+  };
+
+  // Per-frame list of render commands emitted by the scene traversal.
+  //
+  // Sort key layout, most significant first:
+  //   layer (8) | renderer (4) | shader (4) | texture (20) | sequence (28)
+  // Renderer, shader and texture are only filled in for layers marked
+  // sortable, every other layer keeps painter's order through the
+  // traversal sequence number.
+  class RenderCommandQueue {
+  public:
+    static constexpr unsigned LayerShift = 56;
+    static constexpr unsigned RendererShift = 52;
+    static constexpr unsigned ShaderShift = 48;
+    static constexpr unsigned TextureShift = 28;
+
+    static constexpr uint64_t RendererMask = 0xF;
+    static constexpr uint64_t ShaderMask = 0xF;
+    static constexpr uint64_t TextureMask = 0xFFFFF;
+    static constexpr uint64_t SequenceMask = 0xFFFFFFF;
+
+  private:
+    std::vector<RenderCommand> m_Commands;
+    std::vector<RenderCommand> m_Scratch;
+    std::bitset<256> m_SortableLayers;
+    uint32_t m_Sequence = 0;
+
+  public:
+    // Lets commands of the layer be grouped by renderer, shader and texture
+    // regardless of their traversal order. Only sound for layers whose
+    // objects don't overlap or don't depend on their blending order.
+    void SetLayerSortable(uint8_t layer, bool sortable) {
+      m_SortableLayers.set(layer, sortable);
+    }
+
+    bool IsLayerSortable(uint8_t layer) const {
+      return m_SortableLayers.test(layer);
+    }
+
+    const std::bitset<256>& GetSortableLayers() const {
+      return m_SortableLayers;
+    }
+
+    void SetSortableLayers(const std::bitset<256>& layers) {
+      m_SortableLayers = layers;
+    }
+
+    void Clear() {
+      m_Commands.clear();
+      m_Sequence = 0;
+    }
+
+    void Push(uint8_t layer, ObjectRendererType renderer, uint8_t shader,
+              uint32_t texture, DisplayObject* object);
+
+    // Stable LSD radix sort on the sort keys, byte digits which are equal
+    // for all commands are skipped.
+    void Sort();
+
+    const std::vector<RenderCommand>& GetCommands() const {
+      return m_Commands;
+    }
+  };
+
+} // end namespace neonGX
+
+#endif // !NEONGX_RENDERCOMMANDQUEUE_H
@@ -0,0 +1,63 @@
+/*
+ * neonGX - RenderSnapshot.hpp
+ *
+ * Copyright (c) 2016, cynecx
+ *
+ * This file is part of neonGX and is distributed under a modified
+ * BSD 3-Clause License. See LICENSE.txt for details.
+ *
+ */
+
+#ifndef NEONGX_RENDERSNAPSHOT_H
+#define NEONGX_RENDERSNAPSHOT_H
+
+#include <neonGX/Core/Renderer/OpenGL/GLRenderer.hpp>
+#include <neonGX/Core/Sprites/SpriteVertexPacker.hpp>
+#include <neonGX/Core/Text/Text.hpp>
+#include <neonGX/Core/Textures/BaseTexture.hpp>
+#include <memory>
+#include <vector>
+
+namespace neonGX {
+
+  // A sorted render command, Index points into the list of its renderer.
+  struct RenderSnapshotCommand {
+    ObjectRendererType Renderer;
+    size_t Index;
+  };
+
+  struct RenderSnapshotText {
+    size_t GlyphStart;
+    size_t GlyphCount;
+    FontRenderMode Mode;
+    ColorRGB Color;
+  };
+
+  // Copy of everything needed to draw a frame, built by the game thread and
+  // drawn by the render thread without touching any display object.
+  struct RenderSnapshot {
+    std::vector<RenderSnapshotCommand> Commands;
+    std::vector<SpriteVertexRecord> Sprites;
+    std::vector<RenderSnapshotText> Texts;
+    std::vector<TextGlyphQuad> Glyphs;
+
+    // Keeps the textures of the captured sprites alive until the snapshot
+    // has been drawn.
+    std::vector<std::shared_ptr<BaseTexture>> Textures;
+
+    // Traversal side counters, completed by the render thread.
+    GLRendererStats Stats;
+
+    void Clear() {
+      Commands.clear();
+      Sprites.clear();
+      Texts.clear();
+      Glyphs.clear();
+      Textures.clear();
+      Stats = GLRendererStats{};
+    }
+  };
+
+} // end namespace neonGX
+
+#endif // !NEONGX_RENDERSNAPSHOT_H
@@ -0,0 +1,68 @@
+/*
+ * neonGX - RenderThread.hpp
+ *
+ * Copyright (c) 2016, cynecx
+ *
+ * This file is part of neonGX and is distributed under a modified
+ * BSD 3-Clause License. See LICENSE.txt for details.
+ *
+ */
+
+#ifndef NEONGX_RENDERTHREAD_H
+#define NEONGX_RENDERTHREAD_H
+
+#include <neonGX/Core/Renderer/OpenGL/RenderSnapshot.hpp>
+#include <array>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace neonGX {
+
+  // Draws and presents the snapshots published by the game thread (desktop
+  // only). The game thread fills one snapshot while the other one is drawn,
+  // frame N + 1 is simulated while frame N is submitted and presented.
+  class RenderThread {
+  private:
+    GLRenderer* m_Renderer;
+
+    std::array<RenderSnapshot, 2> m_Snapshots;
+    size_t m_WriteIndex = 0;
+
+    std::mutex m_Mutex;
+    std::condition_variable m_Published;
+    std::condition_variable m_Drawn;
+    // The snapshot at m_WriteIndex ^ 1 waits to be drawn or is drawn.
+    bool m_Pending = false;
+    bool m_Drawing = false;
+    bool m_Stopping = false;
+
+    std::thread m_Thread;
+
+    void ThreadLoop();
+
+  public:
+    explicit RenderThread(GLRenderer* renderer);
+    ~RenderThread();
+
+    RenderThread(const RenderThread&) = delete;
+    RenderThread& operator=(const RenderThread&) = delete;
+
+    // The snapshot owned by the game thread until the next Publish.
+    RenderSnapshot& GetWriteSnapshot() {
+      return m_Snapshots[m_WriteIndex];
+    }
+
+    // Hands the write snapshot over to the render thread. Waits for the
+    // previous snapshot to be drawn first and copies the renderer stats of
+    // it into lastFrameStats.
+    void Publish(GLRendererStats& lastFrameStats);
+
+    // Waits for every published snapshot to be drawn, afterwards the GL
+    // context may be used by the calling thread until the next Publish.
+    void Finish();
+  };
+
+} // end namespace neonGX
+
+#endif // !NEONGX_RENDERTHREAD_H
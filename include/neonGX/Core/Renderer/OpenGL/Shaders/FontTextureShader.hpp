@@ -11,7 +11,7 @@
 #ifndef NEONGX_FONTTEXTURESHADER_H
 #define NEONGX_FONTTEXTURESHADER_H
 
-#include <neonGX/Core/Math/Matrix.hpp>
+#include <neonGX/Core/Math/Affine2D.hpp>
 #include <neonGX/Core/Renderer/OpenGL/Shaders/GLShader.hpp>
 #include <neonGX/Core/Textures/Texture.hpp>
 #include <GSL/span.h>
@@ -21,15 +21,22 @@ namespace neonGX {
   class ShaderManager;
 
   class FontTextureShader : public GLShader {
-  private:
+  protected:
     ShaderManager* m_ShaderManager;
 
+    FontTextureShader(webgl_context_handle glHandle,
+                      ShaderManager* shaderManager,
+                      const std::string& fragmentSrc);
+
+    // Makes this the current program before uniforms get updated.
+    virtual void Activate();
+
   public:
     FontTextureShader(webgl_context_handle glHandle,
                       ShaderManager* shaderManager);
     virtual ~FontTextureShader();
 
-    void SetProjectionMatrix(const Matrix3& mat);
+    void SetProjectionMatrix(const Affine2D& mat);
   };
 
 } // end namespace neonGX
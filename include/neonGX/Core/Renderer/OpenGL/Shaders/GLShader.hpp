@@ -60,6 +60,7 @@ namespace neonGX {
     void Bind();
 
   private:
+    void UseProgram();
     void CompileShaders();
     void InitializeShaders();
   };
@@ -0,0 +1,33 @@
+/*
+ * neonGX - InstancedTextureShader.hpp
+ *
+ * Copyright (c) 2016, cynecx
+ *
+ * This file is part of neonGX and is distributed under a modified
+ * BSD 3-Clause License. See LICENSE.txt for details.
+ *
+ */
+
+#ifndef NEONGX_INSTANCEDTEXTURESHADER_H
+#define NEONGX_INSTANCEDTEXTURESHADER_H
+
+#include <neonGX/Core/Renderer/OpenGL/Shaders/TextureShader.hpp>
+
+namespace neonGX {
+
+  // TextureShader variant which expands a unit quad (aQuadCorner) with a
+  // per-instance affine transform and texture frame.
+  class InstancedTextureShader final : public TextureShader {
+  protected:
+    void Activate() override;
+
+  public:
+    InstancedTextureShader(webgl_context_handle glHandle,
+                           ShaderManager* shaderManager,
+                           size_t textureCount = 1);
+    virtual ~InstancedTextureShader();
+  };
+
+} // end namespace neonGX
+
+#endif // !NEONGX_INSTANCEDTEXTURESHADER_H
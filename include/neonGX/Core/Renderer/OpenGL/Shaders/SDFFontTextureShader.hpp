@@ -0,0 +1,35 @@
+/*
+ * neonGX - SDFFontTextureShader.hpp
+ *
+ * Copyright (c) 2016, cynecx
+ *
+ * This file is part of neonGX and is distributed under a modified
+ * BSD 3-Clause License. See LICENSE.txt for details.
+ *
+ */
+
+#ifndef NEONGX_SDFFONTTEXTURESHADER_H
+#define NEONGX_SDFFONTTEXTURESHADER_H
+
+#include <neonGX/Core/Renderer/OpenGL/Shaders/FontTextureShader.hpp>
+
+namespace neonGX {
+
+  // FontTextureShader variant which reconstructs glyph edges from a signed
+  // distance field. The edge width follows the screen-space derivative of
+  // the field if OES_standard_derivatives is available, otherwise a fixed
+  // width tuned for glyphs drawn around their native size is used.
+  class SDFFontTextureShader final : public FontTextureShader {
+  protected:
+    void Activate() override;
+
+  public:
+    SDFFontTextureShader(webgl_context_handle glHandle,
+                         ShaderManager* shaderManager,
+                         bool standardDerivatives);
+    virtual ~SDFFontTextureShader();
+  };
+
+} // end namespace neonGX
+
+#endif // !NEONGX_SDFFONTTEXTURESHADER_H
@@ -11,7 +11,7 @@
 #ifndef NEONGX_TEXTURESHADER_H
 #define NEONGX_TEXTURESHADER_H
 
-#include <neonGX/Core/Math/Matrix.hpp>
+#include <neonGX/Core/Math/Affine2D.hpp>
 #include <neonGX/Core/Renderer/OpenGL/Shaders/GLShader.hpp>
 #include <neonGX/Core/Textures/Texture.hpp>
 #include <GSL/span.h>
@@ -22,16 +22,33 @@ namespace neonGX {
 
   class TextureShader : public GLShader {
   private:
+    // Number of samplers in uSamplers, every vertex selects one of them
+    // through aTextureId.
     GLint m_TextureCount = 1;
+
+  protected:
     ShaderManager* m_ShaderManager;
 
+    TextureShader(webgl_context_handle glHandle,
+                  ShaderManager* shaderManager,
+                  size_t textureCount,
+                  const std::string& vertexSrc);
+
+    // Makes this the current program before uniforms get updated.
+    virtual void Activate();
+
   public:
     TextureShader(webgl_context_handle glHandle,
-                  ShaderManager* shaderManager);
+                  ShaderManager* shaderManager,
+                  size_t textureCount = 1);
     virtual ~TextureShader();
 
-    void SetProjectionMatrix(const Matrix3& mat);
-    void SetSampler2D(BaseTexture& data);
+    size_t GetTextureCount() const {
+      return size_t(m_TextureCount);
+    }
+
+    void SetProjectionMatrix(const Affine2D& mat);
+    void SetSamplerUnits();
   };
 
 } // end namespace neonGX
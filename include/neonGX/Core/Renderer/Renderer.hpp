@@ -13,16 +13,68 @@
 
 #include <neonGX/Core/Math/Primitives.hpp>
 #include <neonGX/Core/Graphics/Color.hpp>
+#include <cstddef>
 
 namespace neonGX {
 
   class DisplayObject;
 
+  enum class VertexFormat {
+    // Float texture coordinates and colors.
+    Standard,
+    // Normalized uint16 texture coordinates and RGBA8 colors.
+    Compact
+  };
+
   struct RendererSettings {
     bool Transparent = false;
     bool ClearBeforeRender = true;
     ColorRGB BackgroundColor{};
     int Resolution = 1;
+
+    // Upper bound of textures a single sprite batch may sample from, it is
+    // clamped to GL_MAX_TEXTURE_IMAGE_UNITS. 1 disables multi-texturing.
+    size_t MaxBatchTextures = 16;
+
+    // Keeps the vertices of every sprite in a persistent buffer and only
+    // re-uploads the sprites which changed since the last frame.
+    bool RetainedSprites = false;
+
+    // Lets SpriteRenderer move sprites next to earlier sprites sharing their
+    // texture, as long as no sprite they would skip overlaps them.
+    bool ReorderSpriteBatches = false;
+
+    // Draws every sprite as an instance of a single quad whenever instanced
+    // arrays are available. RetainedSprites takes precedence.
+    bool InstancedSprites = true;
+
+    // Vertex layout used by the sprite and text batches.
+    VertexFormat BatchVertexFormat = VertexFormat::Standard;
+
+    // Glyph atlas pages kept before the least recently used one gets
+    // evicted. Pages used by the current frame are never evicted.
+    size_t MaxGlyphAtlasPages = 4;
+
+    // Worker threads computing and packing sprite vertices in parallel, 0
+    // builds the batches on the render thread. Both produce the same data.
+    size_t BatchWorkerThreads = 0;
+
+    // Desktop only, a dedicated thread owns the GL context. Render copies
+    // the sorted render commands into a snapshot which the thread draws and
+    // presents while the game thread goes on with the next frame. Implies
+    // RetainedSprites = false.
+    bool UseRenderThread = false;
+
+    // Only redraws the regions of the canvas which changed since the last
+    // frame and skips frames without any change. WebGL contexts get a
+    // preserved drawing buffer, desktop windows repair their back buffer
+    // from its GLX_EXT_buffer_age and redraw it as a whole wherever the age
+    // is unknown. Ignored together with UseRenderThread.
+    bool PartialRedraw = false;
+
+    // Skips display objects, and whole containers, whose cached world
+    // bounds lie outside of the render target.
+    bool CullOffscreen = true;
   };
 
   class Renderer {
@@ -39,6 +91,10 @@ namespace neonGX {
 
     virtual ~Renderer();
 
+    const RendererSettings& GetSettings() const {
+      return m_Settings;
+    }
+
     virtual void Render(DisplayObject* object) = 0;
 
     virtual void Resize(const FSize& size) {
@@ -16,6 +16,7 @@
 #include <neonGX/Core/Display/Container.hpp>
 #include <neonGX/Core/Textures/Texture.hpp>
 #include <neonGX/Core/Renderer/OpenGL/GLRenderer.hpp>
+#include <neonGX/Core/Sprites/SpriteVertexPool.hpp>
 #include <array>
 #include <cmath>
 #include <memory>
@@ -37,6 +38,23 @@ namespace neonGX {
     std::array<float, 8> m_VertexData;
     uint32_t m_Tint = 0xFFFFFF;
 
+    std::weak_ptr<SpriteVertexPool> m_VertexPool;
+    uint32_t m_VertexSlot = SpriteVertexPool::InvalidSlot;
+    bool m_VertexSlotDirty = true;
+    // World version the vertex slot was last packed with.
+    uint32_t m_VertexSlotVersion = 0;
+
+    // Pixels of the texture with a lower alpha are not hit, 0 hits the
+    // whole quad.
+    uint8_t m_HitAlphaThreshold = 0;
+
+  protected:
+    bool HitTestLocal(const FPoint& point) override;
+
+    void OnWorldTransformChanged() override {
+      m_TextureDirty = true;
+    }
+
   public:
     Sprite(const std::shared_ptr<Texture>& texture);
     virtual ~Sprite();
@@ -52,6 +70,7 @@ namespace neonGX {
     void SetAnchor(const FPoint& point) {
       m_TextureDirty = true;
       m_Anchor = point;
+      ContentChanged();
     }
 
     FSize GetSize() const {
@@ -69,11 +88,48 @@ namespace neonGX {
       m_Scale.y =
           ExtractSign(m_Scale.y) * size.height / textureSize.height;
       m_CurrSize = size;
+      TransformChanged();
+    }
+
+    uint8_t GetHitAlphaThreshold() const {
+      return m_HitAlphaThreshold;
+    }
+
+    // Pixel accurate hit testing against the alpha channel of the texture
+    // image. Textures without an image in memory, like render textures,
+    // hit the whole quad.
+    void SetHitAlphaThreshold(uint8_t threshold) {
+      m_HitAlphaThreshold = threshold;
     }
 
     void SetTexture(const std::shared_ptr<Texture>& texture);
     void CalculateVertices();
 
+    void UpdateVertices() {
+      if(m_TextureDirty) {
+        m_TextureDirty = false;
+        CalculateVertices();
+      }
+    }
+
+    // World space bounds of the quad.
+    NRectangle GetBounds() override;
+
+    // Children are not drawn, only the quad counts.
+    optional<NRectangle> GetCachedWorldBounds() override {
+      return DisplayObject::GetCachedWorldBounds();
+    }
+
+    bool RendersChildren() const override {
+      return false;
+    }
+
+    using Container::HitTest;
+
+    DisplayObject* HitTest(const FPoint& point) override {
+      return DisplayObject::HitTest(point);
+    }
+
     void OnStateChanged() override {
       Container::OnStateChanged();
       m_TextureDirty = true;
@@ -16,6 +16,8 @@
 #include <neonGX/Core/Renderer/OpenGL/ObjectRenderer.hpp>
 #include <neonGX/Core/Renderer/OpenGL/GLBuffer.hpp>
 #include <neonGX/Core/Renderer/OpenGL/Shaders/TextureShader.hpp>
+#include <neonGX/Core/Sprites/SpriteVertexPacker.hpp>
+#include <neonGX/Core/Sprites/SpriteVertexPool.hpp>
 #include <neonGX/Core/Textures/Texture.hpp>
 #include <algorithm>
 #include <array>
@@ -28,12 +30,54 @@ namespace neonGX {
 
   class SpriteRenderer final : public ObjectRenderer {
   private:
-    // position{X, Y} = 2 x FPoint, Color{R, G, B} = 4 x byte (Normalized)
-    static constexpr size_t VertexDataCount = 5;
+    // position{X, Y} = 2 x FPoint, Color{R, G, B} = 4 x byte (Normalized),
+    // TextureId = 1 x float
+    static constexpr size_t VertexDataCount = 6;
     static constexpr size_t VertexByteSize = VertexDataCount * sizeof(float);
+    // translation 2 x float, transform 4 x float, frame 4 x float,
+    // color 4 x byte, textureId 1 x float
+    static constexpr size_t InstanceByteSize = 12 * sizeof(float);
+    // VertexFormat::Compact, texture coordinates as 2 x uint16 (Normalized)
+    // and the textureId as 1 x byte + 3 bytes padding.
+    static constexpr size_t CompactVertexByteSize = 20;
+    static constexpr size_t CompactInstanceByteSize = 40;
     static constexpr size_t BatchSize = 2000;
+    static constexpr size_t MaxBatchTextures = 32;
+    // Number of full batches the streaming vertex buffer holds before it
+    // gets orphaned.
+    static constexpr size_t StreamedBatches = 4;
+    // Number of preceding groups a sprite may be moved across by the
+    // reorder pass.
+    static constexpr size_t ReorderWindow = 16;
+    // Records per job of the parallel packing, a multiple of the 4 records
+    // the SIMD kernels pack at once so each record takes the same path as
+    // in a serial flush.
+    static constexpr size_t PackGrain = 256;
+
+    // A range of sprites which can be drawn with a single draw call, every
+    // sprite samples from one of the (up to MaxBatchTextures) textures.
+    struct SpriteBatch {
+      size_t Start = 0;
+      size_t Size = 0;
+      size_t TextureCount = 0;
+      std::array<BaseTexture*, MaxBatchTextures> Textures;
+    };
+
+    // Sprites collected by the reorder pass which are drawn back to back,
+    // along with the world-space bounds they cover.
+    struct ReorderGroup {
+      float MinX, MinY, MaxX, MaxY;
+      size_t Size = 0;
+      size_t TextureCount = 0;
+      std::array<BaseTexture*, MaxBatchTextures> Textures;
+    };
 
     webgl_context_handle m_GLHandle;
+    size_t m_MaxBatchTextures = 1;
+
+    bool m_CompactVertices = false;
+    size_t m_VertexByteSize = VertexByteSize;
+    size_t m_InstanceByteSize = InstanceByteSize;
 
     std::vector<uint8_t> m_Vertices;
     std::vector<uint16_t> m_Indices;
@@ -41,7 +85,34 @@ namespace neonGX {
     std::shared_ptr<GLBuffer> m_VertexBuffer;
     std::shared_ptr<GLBuffer> m_IndexBuffer;
 
-    std::vector<Sprite*> m_Sprites;
+    // Instanced mode, a single unit quad expanded by one record per sprite.
+    bool m_Instanced = false;
+    std::shared_ptr<GLBuffer> m_QuadVertexBuffer;
+    std::shared_ptr<GLBuffer> m_QuadIndexBuffer;
+    std::shared_ptr<GLBuffer> m_InstanceBuffer;
+
+    std::vector<SpriteVertexRecord> m_Records;
+    std::vector<SpriteBatch> m_Batches;
+
+    bool m_ReorderBatches = false;
+    std::vector<ReorderGroup> m_ReorderGroups;
+    std::vector<uint32_t> m_RecordGroups;
+    std::vector<SpriteVertexRecord> m_SortedRecords;
+
+    // Retained mode, sprites are drawn straight from their pool slots by
+    // indexing them in render order.
+    std::shared_ptr<SpriteVertexPool> m_VertexPool;
+    std::vector<SpriteVertexRecord> m_DirtyRecords;
+    std::vector<uint16_t> m_SlotIndices;
+
+    // Every flush of a frame owns an index buffer, so rewriting one never
+    // has to wait for the draws of an earlier flush reading it.
+    struct SlotIndexList {
+      std::shared_ptr<GLBuffer> Buffer;
+      std::vector<uint16_t> Uploaded;
+    };
+    std::vector<SlotIndexList> m_SlotIndexLists;
+    size_t m_SlotIndexFlush = 0;
 
     GLRenderer* m_Renderer;
 
@@ -51,12 +122,32 @@ namespace neonGX {
 
   private:
     void CreateIndicesForQuads();
+    void SetVertexAttributes(size_t baseOffset);
+    void SetInstanceAttributes(size_t baseOffset);
+    void SetInstanceDivisors(GLuint divisor);
+    void BindBatchTextures(const SpriteBatch& batch);
+    void BuildBatches();
+    void ReorderRecords();
+    // Packs records into m_Vertices, in the layout of the current mode.
+    void PackRecords(const std::vector<SpriteVertexRecord>& records);
+    bool UpdateVertexPool();
+    void UploadSlotIndices();
 
   public:
+    // Restarts the per flush index lists, called once per submission.
+    void BeginFrame();
+
     void Start() override;
     void Stop() override;
     void Flush() override;
     void Render(DisplayObject* object) override;
+
+    void RenderRecord(const SpriteVertexRecord& record);
+
+    // Copies the vertices, texture frame and color of the sprite, the
+    // vertex slot is left invalid.
+    static void CaptureRecord(const Sprite& sprite,
+                              SpriteVertexRecord& record);
   };
 
 } // end namespace neonGX
@@ -0,0 +1,71 @@
+/*
+ * neonGX - SpriteVertexPacker.hpp
+ *
+ * Copyright (c) 2016, cynecx
+ *
+ * This file is part of neonGX and is distributed under a modified
+ * BSD 3-Clause License. See LICENSE.txt for details.
+ *
+ */
+
+#ifndef NEONGX_SPRITEVERTEXPACKER_H
+#define NEONGX_SPRITEVERTEXPACKER_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace neonGX {
+
+  struct BaseTexture;
+
+  // Everything SpriteRenderer needs to know about a queued sprite, captured
+  // into a contiguous staging array so the packing kernel never has to chase
+  // Sprite/Texture pointers.
+  struct alignas(16) SpriteVertexRecord {
+    // Transformed quad corners {x0, y0, ..., x3, y3}
+    std::array<float, 8> Positions;
+    // Texture coordinates of the corners {u0, v0, ..., u3, v3}
+    std::array<float, 8> UVs;
+    // 0xRRGGBB
+    uint32_t Tint;
+    float Alpha;
+    // Texture unit within the batch, assigned by SpriteRenderer::Flush.
+    float TextureId;
+    BaseTexture* Texture;
+    // Persistent slot within the SpriteVertexPool (retained sprites only).
+    uint32_t VertexSlot;
+    // Set if the slot contents are stale and have to be packed again.
+    bool VertexSlotDirty;
+  };
+
+  // Interleaves {x, y, u, v, color, textureId} for the 4 vertices of every
+  // record into output (24 bytes per vertex). Uses SSE2 or WebAssembly SIMD
+  // whenever the target supports it.
+  void PackSpriteVertices(const SpriteVertexRecord* records, size_t count,
+                          uint8_t* output);
+
+  // Portable reference implementation of PackSpriteVertices.
+  void PackSpriteVerticesScalar(const SpriteVertexRecord* records,
+                                size_t count, uint8_t* output);
+
+  // Writes a single instance per record (48 bytes): the affine transform of
+  // the unit quad {x0, y0, x1 - x0, y1 - y0, x3 - x0, y3 - y0}, the texture
+  // frame {u0, v0, u2, v2}, color and textureId.
+  void PackSpriteInstances(const SpriteVertexRecord* records, size_t count,
+                           uint8_t* output);
+
+  // Compact variant of PackSpriteVertices (20 bytes per vertex), the texture
+  // coordinates are stored as normalized uint16 and the textureId as a
+  // single byte followed by 3 bytes of padding.
+  void PackSpriteVerticesCompact(const SpriteVertexRecord* records,
+                                 size_t count, uint8_t* output);
+
+  // Compact variant of PackSpriteInstances (40 bytes per instance), with the
+  // same frame and textureId encoding as PackSpriteVerticesCompact.
+  void PackSpriteInstancesCompact(const SpriteVertexRecord* records,
+                                  size_t count, uint8_t* output);
+
+} // end namespace neonGX
+
+#endif // !NEONGX_SPRITEVERTEXPACKER_H
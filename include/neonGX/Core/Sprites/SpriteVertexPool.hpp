@@ -0,0 +1,122 @@
+/*
+ * neonGX - SpriteVertexPool.hpp
+ *
+ * Copyright (c) 2016, cynecx
+ *
+ * This file is part of neonGX and is distributed under a modified
+ * BSD 3-Clause License. See LICENSE.txt for details.
+ *
+ */
+
+#ifndef NEONGX_SPRITEVERTEXPOOL_H
+#define NEONGX_SPRITEVERTEXPOOL_H
+
+#include <neonGX/Core/Renderer/OpenGL/GLContext.hpp>
+#include <neonGX/Core/Renderer/OpenGL/GLBuffer.hpp>
+#include <GSL/span.h>
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <vector>
+
+namespace neonGX {
+
+  // Persistent vertex storage for retained sprites. Every sprite owns a
+  // stable slot (4 vertices) and only slots which were updated are
+  // re-uploaded, coalesced into as few glBufferSubData calls as possible.
+  //
+  // The batch relative texture unit of a sprite depends on the other
+  // sprites of the frame, it is kept in a separate byte per vertex so a
+  // changed batch layout never touches the vertices themselves.
+  class SpriteVertexPool {
+  public:
+    static constexpr uint32_t InvalidSlot =
+        std::numeric_limits<uint32_t>::max();
+
+    // Slots are addressed through 16 bit indices.
+    static constexpr size_t MaxSlots = 65536 / 4;
+
+  private:
+    static constexpr size_t InitialSlots = 1024;
+
+    // Clean slots in between two dirty ranges that are uploaded anyway
+    // instead of issuing another glBufferSubData.
+    static constexpr size_t MergeGap = 4;
+
+    // CPU copy and GPU buffer of one per slot attribute stream.
+    struct SlotStore {
+      size_t SlotByteSize;
+      std::vector<uint8_t> Data;
+      std::vector<uint32_t> DirtySlots;
+      std::vector<bool> SlotQueued;
+      std::unique_ptr<GLBuffer> Buffer;
+      bool Reallocated = true;
+
+      uint8_t* GetSlotData(uint32_t slot) {
+        return Data.data() + slot * SlotByteSize;
+      }
+
+      void Resize(size_t slotCount);
+      void MarkDirty(uint32_t slot);
+      size_t Upload();
+    };
+
+    webgl_context_handle m_GLHandle;
+
+    SlotStore m_Vertices;
+    SlotStore m_TextureIds;
+    std::vector<uint32_t> m_FreeSlots;
+
+    size_t m_SlotCount = 0;
+    size_t m_UploadedBytes = 0;
+
+    void Grow();
+
+  public:
+    SpriteVertexPool(webgl_context_handle glHandle, size_t slotByteSize);
+    ~SpriteVertexPool();
+
+    SpriteVertexPool(const SpriteVertexPool&) = delete;
+    SpriteVertexPool& operator=(const SpriteVertexPool&) = delete;
+
+    uint32_t Allocate();
+    void Free(uint32_t slot);
+
+    // Stores the packed vertices of a slot, callers only pass slots whose
+    // sprite changed. The texture id stored along with the vertices is
+    // ignored, see SetTextureId.
+    void Update(uint32_t slot, gsl::span<const uint8_t> vertices);
+
+    // Sets the texture unit all 4 vertices of the slot sample from.
+    void SetTextureId(uint32_t slot, uint8_t textureId) {
+      assert(slot < m_SlotCount);
+      uint8_t* ids = m_TextureIds.GetSlotData(slot);
+      if(ids[0] != textureId) {
+        std::fill(ids, ids + 4, textureId);
+        m_TextureIds.MarkDirty(slot);
+      }
+    }
+
+    // Uploads all dirty ranges, returns the amount of uploaded bytes.
+    size_t Upload();
+
+    size_t GetUploadedBytes() const {
+      return m_UploadedBytes;
+    }
+
+    GLBuffer& GetVertexBuffer() {
+      return *m_Vertices.Buffer;
+    }
+
+    // One unsigned byte per vertex.
+    GLBuffer& GetTextureIdBuffer() {
+      return *m_TextureIds.Buffer;
+    }
+  };
+
+} // end namespace neonGX
+
+#endif // !NEONGX_SPRITEVERTEXPOOL_H
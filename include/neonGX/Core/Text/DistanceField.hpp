@@ -0,0 +1,30 @@
+/*
+ * neonGX - DistanceField.hpp
+ *
+ * Copyright (c) 2016, cynecx
+ *
+ * This file is part of neonGX and is distributed under a modified
+ * BSD 3-Clause License. See LICENSE.txt for details.
+ *
+ */
+
+#ifndef NEONGX_DISTANCEFIELD_H
+#define NEONGX_DISTANCEFIELD_H
+
+#include <cstdint>
+#include <vector>
+
+namespace neonGX {
+
+  // Converts an 8-bit coverage bitmap into a signed distance field with a
+  // border of `spread` pixels on every side, the result is
+  // (width + 2 * spread) x (height + 2 * spread) bytes. 128 lies on the
+  // outline, larger values are inside; `spread` pixels away from the
+  // outline the field saturates to 0 or 255.
+  std::vector<uint8_t> GenerateDistanceField(const uint8_t* bitmap,
+                                             int32_t width, int32_t height,
+                                             int32_t pitch, int32_t spread);
+
+} // end namespace neonGX
+
+#endif // !NEONGX_DISTANCEFIELD_H
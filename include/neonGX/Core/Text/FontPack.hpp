@@ -0,0 +1,106 @@
+/*
+ * neonGX - FontPack.hpp
+ *
+ * Copyright (c) 2016, cynecx
+ *
+ * This file is part of neonGX and is distributed under a modified
+ * BSD 3-Clause License. See LICENSE.txt for details.
+ *
+ */
+
+#ifndef NEONGX_FONTPACK_H
+#define NEONGX_FONTPACK_H
+
+#include <neonGX/Core/ADT.hpp>
+#include <GSL/span.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace neonGX {
+
+  // Font packs are cooked offline by tools/FontCook. The layout is
+  // FontPackHeader, GlyphCount x FontPackGlyph,
+  // KerningCount x FontPackKerning and AtlasWidth x AtlasHeight 8-bit
+  // atlas pixels, all little endian.
+  static constexpr uint32_t FontPackMagic = 0x4658474E; // "NGXF"
+  static constexpr uint32_t FontPackVersion = 1;
+
+  struct FontPackHeader {
+    uint32_t Magic;
+    uint32_t Version;
+    uint32_t Height;
+    // FontRenderMode
+    uint32_t Mode;
+    int32_t Ascender;
+    uint32_t AtlasWidth;
+    uint32_t AtlasHeight;
+    uint32_t GlyphCount;
+    uint32_t KerningCount;
+  };
+
+  struct FontPackGlyph {
+    uint32_t Codepoint;
+    // Bitmap rectangle on the atlas image, empty for blank glyphs.
+    uint16_t X;
+    uint16_t Y;
+    uint16_t Width;
+    uint16_t Height;
+    int16_t BearingX;
+    int16_t BearingY;
+    // 26.6 fixed point, like FreeType advances.
+    int32_t AdvanceX;
+  };
+
+  struct FontPackKerning {
+    uint32_t Left;
+    uint32_t Right;
+    // 26.6 fixed point
+    int32_t AdvanceX;
+  };
+
+  static_assert(sizeof(FontPackHeader) == 36, "Unexpected header padding.");
+  static_assert(sizeof(FontPackGlyph) == 20, "Unexpected glyph padding.");
+  static_assert(sizeof(FontPackKerning) == 12, "Unexpected kerning padding.");
+
+  // A validated view onto the bytes of a font pack.
+  struct FontPackView {
+    FontPackHeader Header;
+    gsl::span<const FontPackGlyph> Glyphs;
+    gsl::span<const FontPackKerning> Kernings;
+    gsl::span<const uint8_t> AtlasPixels;
+  };
+
+  optional<FontPackView> ParseFontPack(gsl::span<const uint8_t> data);
+
+  bool WriteFontPack(const std::string& filename,
+                     const FontPackHeader& header,
+                     const std::vector<FontPackGlyph>& glyphs,
+                     const std::vector<FontPackKerning>& kernings,
+                     const std::vector<uint8_t>& atlasPixels);
+
+  // Read-only memory mapping of a whole file.
+  class MappedFile {
+  private:
+    const uint8_t* m_Data = nullptr;
+    size_t m_Size = 0;
+
+  public:
+    explicit MappedFile(const std::string& filename);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool IsValid() const {
+      return m_Data != nullptr;
+    }
+
+    gsl::span<const uint8_t> GetData() const {
+      return {m_Data, std::ptrdiff_t(m_Size)};
+    }
+  };
+
+} // end namespace neonGX
+
+#endif // !NEONGX_FONTPACK_H
@@ -11,51 +11,140 @@
 #ifndef NEONGX_FONTTEXTUREMANAGER_H
 #define NEONGX_FONTTEXTUREMANAGER_H
 
-#include <ft2build.h>
-#include FT_FREETYPE_H
-
 #include <neonGX/Core/ADT.hpp>
 #include <neonGX/Core/Math/Primitives.hpp>
 #include <neonGX/Core/Renderer/OpenGL/GLContext.hpp>
 #include <neonGX/Core/Renderer/OpenGL/GLTexture.hpp>
+#include <neonGX/Core/Text/GlyphAtlas.hpp>
+#include <neonGX/Core/Text/GlyphRasterizer.hpp>
+#include <neonGX/Core/Threading/WorkerPool.hpp>
 
+#include <array>
 #include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 namespace neonGX {
 
   struct FontCharacterData {
-    GLTexture Texture;
+    // Atlas page of the glyph bitmap and its texture coordinates on it,
+    // {u0, v0, u1, v1}. Glyphs without a bitmap have an empty Size.
+    size_t Page;
+    uint32_t Generation;
+    std::array<float, 4> UVs;
+    FSize Size;
     int32_t BearingX;
     int32_t BearingY;
     int32_t AdvanceX;
     int32_t DescentY;
   };
 
+#ifdef NEONGX_USE_FREETYPE
+  struct FTLibraryDeleter {
+    void operator()(FT_Library library) const {
+      FT_Done_FreeType(library);
+    }
+  };
+
+  struct FTFaceDeleter {
+    void operator()(FT_Face face) const {
+      FT_Done_Face(face);
+    }
+  };
+#endif
+
+  inline uint64_t KerningKey(char32_t left, char32_t right) {
+    return (uint64_t(left) << 32) | uint64_t(right);
+  }
+
   struct FontData {
     std::string FontSource;
-    std::unordered_map<char16_t, FontCharacterData> CharTextures;
+    FontRenderMode Mode = FontRenderMode::Bitmap;
+    // Pixel size the glyphs are rasterized at, Text scales from it.
+    size_t Height = 0;
+    int32_t Ascender = 0;
+
+#ifdef NEONGX_USE_FREETYPE
+    // Faces opened by a worker come with a library of their own, FreeType
+    // libraries must not be shared between threads. Declared before Face,
+    // it has to outlive it.
+    std::unique_ptr<FT_LibraryRec_, FTLibraryDeleter> Library;
+    // The face stays resident, glyphs are rasterized on first use. Fonts
+    // loaded from a font pack have none.
+    std::unique_ptr<FT_FaceRec_, FTFaceDeleter> Face;
+#endif
+    std::unordered_map<char32_t, FontCharacterData> CharTextures;
+    // Cooked kerning pairs (KerningKey), 26.6 fixed point.
+    std::unordered_map<uint64_t, int32_t> Kerning;
   };
 
+  struct PendingFontLoad;
+
   class FontTextureManager {
   private:
+#ifdef NEONGX_USE_FREETYPE
     FT_Library m_ft2Instance = nullptr;
+#endif
     webgl_context_handle m_GlHandle;
 
     std::unordered_map<std::string, FontData> m_LoadedFontMap;
 
+    GlyphAtlas m_GlyphAtlas;
+
+    // Created by the first LoadFontAsync.
+    std::unique_ptr<WorkerPool> m_WorkerPool;
+    std::vector<std::shared_ptr<PendingFontLoad>> m_PendingLoads;
+
   public:
-    explicit FontTextureManager(webgl_context_handle glHandle);
+    explicit FontTextureManager(
+        webgl_context_handle glHandle,
+        size_t maxAtlasPages = GlyphAtlas::DefaultMaxPages);
     ~FontTextureManager();
 
     FontTextureManager(const FontTextureManager&) = delete;
     FontTextureManager& operator=(const FontTextureManager&) = delete;
 
+#ifdef NEONGX_USE_FREETYPE
+    // With FontRenderMode::DistanceField, height is only the resolution of
+    // the field; something around 32 to 48 pixels serves most text sizes.
     bool LoadFont(const std::string& filename, const std::string& fontName,
-                  size_t height);
-
-    optional<const FontData*> GetFontData(const std::string& key) const;
+                  size_t height,
+                  FontRenderMode mode = FontRenderMode::Bitmap);
+
+    // Rasterizes the printable ASCII glyphs on worker threads, each with
+    // its own FreeType face, and packs them into staging atlas pages. The
+    // font becomes available, and onLoaded gets called, in the
+    // ProcessPendingLoads call following the packing; the pages reach the
+    // GPU with the next atlas upload.
+    std::shared_future<bool> LoadFontAsync(
+        const std::string& filename, const std::string& fontName,
+        size_t height, FontRenderMode mode = FontRenderMode::Bitmap,
+        std::function<void(bool)> onLoaded = {});
+#endif
+
+    // Loads a font pack cooked by tools/FontCook. Its atlas becomes a
+    // pinned atlas page, codepoints missing in the pack render as '?'.
+    bool LoadFontPack(const std::string& filename,
+                      const std::string& fontName);
+
+    // Registers fonts whose rasterization finished, GL thread only.
+    void ProcessPendingLoads();
+
+    optional<FontData*> GetFontData(const std::string& key);
+
+    // Returns the glyph of the codepoint, rasterizing it into the atlas if
+    // it is not cached or its atlas page got evicted. Codepoints missing in
+    // the face resolve to its .notdef glyph.
+    const FontCharacterData& GetCharacter(FontData& fontData,
+                                          char32_t codepoint);
+
+    // Kerning adjustment between two codepoints, 26.6 fixed point.
+    int32_t GetKerning(const FontData& fontData, char32_t left,
+                       char32_t right);
 
     bool IsValidKey(const std::string& key) const {
       return m_LoadedFontMap.find(key) != m_LoadedFontMap.end();
@@ -63,6 +152,10 @@ namespace neonGX {
 
     void DeleteFontData(const std::string& fontName);
 
+    GlyphAtlas& GetGlyphAtlas() {
+      return m_GlyphAtlas;
+    }
+
     void Clear();
   };
 
@@ -0,0 +1,194 @@
+/*
+ * neonGX - GlyphAtlas.hpp
+ *
+ * Copyright (c) 2016, cynecx
+ *
+ * This file is part of neonGX and is distributed under a modified
+ * BSD 3-Clause License. See LICENSE.txt for details.
+ *
+ */
+
+#ifndef NEONGX_GLYPHATLAS_H
+#define NEONGX_GLYPHATLAS_H
+
+#include <neonGX/Core/ADT.hpp>
+#include <neonGX/Core/Math/Primitives.hpp>
+#include <neonGX/Core/Renderer/OpenGL/GLContext.hpp>
+#include <neonGX/Core/Renderer/OpenGL/GLTexture.hpp>
+#include <neonGX/Core/Text/SkylinePacker.hpp>
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace neonGX {
+
+  struct GlyphAtlasRegion {
+    size_t Page;
+    // Bumped whenever the page gets evicted, see GlyphAtlas::IsValid.
+    uint32_t Generation;
+    NRectangle Rect;
+    // {u0, v0, u1, v1}
+    std::array<float, 4> UVs;
+  };
+
+  // GL_LUMINANCE atlas pages shared by all fonts. Glyph bitmaps are kept in
+  // CPU memory and only the rows which changed get uploaded, lazily, right
+  // before the pages are used for rendering.
+  //
+  // Once the page budget is exhausted the least recently used page is
+  // evicted as a whole. Pages used during the current frame are never
+  // evicted, the budget is exceeded instead.
+  class GlyphAtlas {
+  public:
+    static constexpr int32_t DefaultPageSize = 1024;
+    static constexpr size_t DefaultMaxPages = 4;
+
+    // A page packed away from the atlas, possibly on another thread, and
+    // handed over as a whole through AddPage.
+    class StagingPage {
+    private:
+      friend class GlyphAtlas;
+
+      int32_t m_Size;
+      SkylinePacker m_Packer;
+      std::vector<uint8_t> m_Pixels;
+
+    public:
+      explicit StagingPage(int32_t size);
+
+      // Same as GlyphAtlas::Insert, but without adding pages. The page and
+      // generation of the region are only known once the page got added.
+      optional<GlyphAtlasRegion> Insert(int32_t width, int32_t height,
+                                        const uint8_t* pixels,
+                                        int32_t pitch);
+    };
+
+  private:
+    // Empty border around every glyph, keeps linear filtering from
+    // bleeding neighbouring glyphs in.
+    static constexpr int32_t Padding = 1;
+
+    struct Page {
+      SkylinePacker Packer;
+      std::vector<uint8_t> Pixels;
+      std::unique_ptr<GLTexture> Texture;
+
+      // Dirty row band [DirtyBegin, DirtyEnd)
+      int32_t DirtyBegin;
+      int32_t DirtyEnd;
+
+      uint64_t LastUsedFrame = 0;
+      uint32_t Generation = 0;
+
+      // Pre-packed pages are neither packed into nor evicted.
+      bool Pinned = false;
+
+      explicit Page(int32_t size);
+      explicit Page(StagingPage&& staging);
+    };
+
+    webgl_context_handle m_GLHandle;
+    int32_t m_PageSize;
+    size_t m_MaxPages;
+    size_t m_PinnedPages = 0;
+
+    uint64_t m_Frame = 1;
+    size_t m_FramesInFlight = 1;
+    size_t m_EvictedPages = 0;
+
+    std::vector<Page> m_Pages;
+
+    // Guards the pages against a render thread uploading them while glyphs
+    // get inserted. Pages are only ever added, evicted and touched by the
+    // inserting thread.
+    mutable std::mutex m_Mutex;
+
+    // Copies the bitmap into the padded slot at position and returns the
+    // region it landed in, on page 0.
+    static GlyphAtlasRegion CopyGlyph(std::vector<uint8_t>& pagePixels,
+                                      int32_t pageSize,
+                                      const NPoint& position, int32_t width,
+                                      int32_t height, const uint8_t* pixels,
+                                      int32_t pitch);
+
+    // The least recently used page, if it may be evicted. Callers hold
+    // m_Mutex.
+    Page* FindEvictablePage();
+
+  public:
+    explicit GlyphAtlas(webgl_context_handle glHandle,
+                        int32_t pageSize = DefaultPageSize,
+                        size_t maxPages = DefaultMaxPages);
+    ~GlyphAtlas();
+
+    GlyphAtlas(const GlyphAtlas&) = delete;
+    GlyphAtlas& operator=(const GlyphAtlas&) = delete;
+
+    // Copies a width x height 8 bit bitmap (rows are pitch bytes apart)
+    // onto the first page with enough room, a new page is added otherwise.
+    optional<GlyphAtlasRegion> Insert(int32_t width, int32_t height,
+                                      const uint8_t* pixels, int32_t pitch);
+
+    // Adds a page holding a pre-packed width x height image in its top left
+    // corner. Pinned pages don't count towards the page budget.
+    optional<size_t> AddPinnedPage(int32_t width, int32_t height,
+                                   const uint8_t* pixels);
+
+    // Adds a page packed through a StagingPage of the atlas page size and
+    // returns its index. It is packed into and evicted like any other page,
+    // the least recently used page makes room once the budget is reached.
+    size_t AddPage(StagingPage&& staging);
+
+    // Brings the GL textures of all pages up to date.
+    void Upload();
+
+    void NextFrame() {
+      m_Frame++;
+    }
+
+    // Pages used by any of the last framesInFlight frames are kept, a
+    // render thread may still be drawing the previous frame.
+    void SetFramesInFlight(size_t framesInFlight) {
+      m_FramesInFlight = std::max<size_t>(framesInFlight, 1);
+    }
+
+    // Marks the page as used by the current frame.
+    void Touch(size_t page) {
+      assert(page < m_Pages.size());
+      m_Pages[page].LastUsedFrame = m_Frame;
+    }
+
+    // Whether a region handed out by Insert still holds its glyph.
+    bool IsValid(size_t page, uint32_t generation) const {
+      return page < m_Pages.size() && m_Pages[page].Generation == generation;
+    }
+
+    uint32_t GetGeneration(size_t page) const {
+      assert(page < m_Pages.size());
+      return m_Pages[page].Generation;
+    }
+
+    size_t GetEvictedPages() const {
+      return m_EvictedPages;
+    }
+
+    const GLTexture* GetPageTexture(size_t page) const;
+
+    size_t GetPageCount() const {
+      return m_Pages.size();
+    }
+
+    int32_t GetPageSize() const {
+      return m_PageSize;
+    }
+
+    void Clear();
+  };
+
+} // end namespace neonGX
+
+#endif // !NEONGX_GLYPHATLAS_H
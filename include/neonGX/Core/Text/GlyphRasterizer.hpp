@@ -0,0 +1,59 @@
+/*
+ * neonGX - GlyphRasterizer.hpp
+ *
+ * Copyright (c) 2016, cynecx
+ *
+ * This file is part of neonGX and is distributed under a modified
+ * BSD 3-Clause License. See LICENSE.txt for details.
+ *
+ */
+
+#ifndef NEONGX_GLYPHRASTERIZER_H
+#define NEONGX_GLYPHRASTERIZER_H
+
+#ifdef NEONGX_USE_FREETYPE
+#include <ft2build.h>
+#include FT_FREETYPE_H
+#endif
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace neonGX {
+
+  enum class FontRenderMode {
+    // Coverage bitmaps rasterized at the font height.
+    Bitmap,
+    // Signed distance fields, rendered at any scale by the
+    // SDFFontTextureShader.
+    DistanceField
+  };
+
+  // Border around distance field glyphs, in pixels at the font height.
+  static constexpr int32_t DistanceFieldSpread = 4;
+
+  // A glyph bitmap owned outside of FreeType, tightly packed.
+  struct RasterizedGlyph {
+    char32_t Codepoint;
+    int32_t BearingX;
+    int32_t BearingY;
+    int32_t AdvanceX;
+    int32_t Width;
+    int32_t Height;
+    std::vector<uint8_t> Pixels;
+  };
+
+#ifdef NEONGX_USE_FREETYPE
+  // Opens the face and sets its pixel size, nullptr on failure.
+  FT_Face OpenFontFace(FT_Library library, const std::string& filename,
+                       size_t height);
+
+  // Glyphs FreeType fails to load come back empty, without an advance.
+  RasterizedGlyph RasterizeGlyph(FT_Face face, char32_t codepoint,
+                                 FontRenderMode mode);
+#endif
+
+} // end namespace neonGX
+
+#endif // !NEONGX_GLYPHRASTERIZER_H
@@ -0,0 +1,45 @@
+/*
+ * neonGX - SkylinePacker.hpp
+ *
+ * Copyright (c) 2016, cynecx
+ *
+ * This file is part of neonGX and is distributed under a modified
+ * BSD 3-Clause License. See LICENSE.txt for details.
+ *
+ */
+
+#ifndef NEONGX_SKYLINEPACKER_H
+#define NEONGX_SKYLINEPACKER_H
+
+#include <neonGX/Core/ADT.hpp>
+#include <neonGX/Core/Math/Primitives.hpp>
+#include <cstdint>
+#include <vector>
+
+namespace neonGX {
+
+  // Bottom-left skyline rectangle packer.
+  class SkylinePacker {
+  private:
+    struct SkylineNode {
+      int32_t X;
+      int32_t Y;
+      int32_t Width;
+    };
+
+    int32_t m_Width;
+    int32_t m_Height;
+    std::vector<SkylineNode> m_Skyline;
+
+    optional<int32_t> Fit(size_t index, int32_t width, int32_t height) const;
+
+  public:
+    SkylinePacker(int32_t width, int32_t height);
+
+    optional<NPoint> Insert(int32_t width, int32_t height);
+    void Clear();
+  };
+
+} // end namespace neonGX
+
+#endif // !NEONGX_SKYLINEPACKER_H
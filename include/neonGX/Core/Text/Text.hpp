@@ -13,28 +13,85 @@
 
 #include <neonGX/Core/Display/DisplayObject.hpp>
 #include <neonGX/Core/Graphics/Color.hpp>
+#include <neonGX/Core/Text/FontTextureManager.hpp>
+#include <neonGX/Core/Text/UTF8.hpp>
+#include <array>
 #include <string>
-#include <unordered_set>
 #include <vector>
 
 namespace neonGX {
 
+  // A laid out glyph, positions are relative to the text origin and
+  // already scaled to the font size.
+  struct TextLayoutGlyph {
+    char32_t Codepoint;
+    float PenX;
+    float Advance;
+    // {x0, y0, x1, y1}, empty for glyphs without a bitmap.
+    std::array<float, 4> Quad;
+    bool Visible;
+    // Atlas location at layout time, see FontCharacterData.
+    size_t Page;
+    uint32_t Generation;
+    std::array<float, 4> UVs;
+  };
+
+  // A visible glyph ready to be copied into a text batch.
+  struct TextGlyphQuad {
+    // World positions of the corners, clockwise from the top left.
+    std::array<float, 8> Positions;
+    // {u0, v0, u1, v1}
+    std::array<float, 4> UVs;
+    size_t Page;
+    uint32_t Generation;
+    char32_t Codepoint;
+  };
+
   class Text : public DisplayObject {
   public:
     friend class TextRenderer;
 
   private:
     std::string m_Text;
+    // m_Text decoded from UTF-8, every codepoint is rendered as one glyph.
+    std::u32string m_Codepoints;
     std::string m_FontName;
+    // Pixel size the text is laid out at, 0 uses the height the font was
+    // loaded with. Best used with distance field fonts.
+    float m_FontSize = 0.0f;
 
+    // Set by transform and color changes, the vertices get recalculated.
     bool m_IsDirty = true;
-    bool m_HasValidFontData = false;
 
-    std::vector<float> m_VertexData;
-    std::unordered_set<size_t> m_ExcludeSet;
+    // The layout only depends on the text and the font. Glyphs before
+    // m_LayoutValidCount are still valid, SetText keeps the common prefix
+    // of the old and the new text.
+    mutable std::vector<TextLayoutGlyph> m_Layout;
+    mutable size_t m_LayoutValidCount = 0;
+    mutable const FontData* m_LayoutFont = nullptr;
+    mutable float m_LayoutScale = 0.0f;
+    mutable FSize m_LayoutSize;
+
+    // The render mode of the font the quads were resolved with.
+    FontRenderMode m_FontMode = FontRenderMode::Bitmap;
+    std::vector<TextGlyphQuad> m_GlyphQuads;
 
     ColorRGB m_Color{0, 0, 0};
 
+    float GetFontScale(const FontData& fontData) const;
+
+  protected:
+    // Tests the box around the glyphs of the last layout.
+    bool HitTestLocal(const FPoint& point) override;
+
+    void OnWorldTransformChanged() override {
+      m_IsDirty = true;
+    }
+
+  private:
+    void UpdateLayout(FontTextureManager& fontManager,
+                      FontData& fontData) const;
+
   public:
     explicit Text(const std::string& text, const std::string& fontName);
     virtual ~Text() override;
@@ -43,23 +100,43 @@ namespace neonGX {
       return m_Text;
     }
 
-    void SetText(const std::string& text) {
-      m_Text = text;
+    void SetText(const std::string& text);
+
+    float GetFontSize() const {
+      return m_FontSize;
+    }
+
+    void SetFontSize(float fontSize) {
+      m_FontSize = fontSize;
       m_IsDirty = true;
+      ContentChanged();
     }
 
-    ColorRGB& GetColorRef() {
+    const ColorRGB& GetColorRef() const {
       return m_Color;
     }
 
+    void SetColor(const ColorRGB& color) {
+      if(color == m_Color) {
+        return;
+      }
+      m_Color = color;
+      ContentChanged();
+    }
+
     void OnStateChanged() override {
       m_IsDirty = true;
+      m_WorldBoundsValid = false;
     }
 
     FSize GetSize(GLRenderer* renderer) const;
 
     void CalculateVertices(GLRenderer* renderer);
 
+    // World space bounds of the glyphs of the last layout, empty until the
+    // text has been laid out once.
+    NRectangle GetBounds() override;
+
     using DisplayObject::UpdateTransform;
 
     void RenderWebGL(GLRenderer* renderer) override;
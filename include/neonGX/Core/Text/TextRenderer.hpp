@@ -11,34 +11,68 @@
 #ifndef NEONGX_TEXTRENDERER_H
 #define NEONGX_TEXTRENDERER_H
 
+#include <neonGX/Core/Graphics/Color.hpp>
 #include <neonGX/Core/Renderer/OpenGL/ObjectRenderer.hpp>
 #include <neonGX/Core/Renderer/OpenGL/GLBuffer.hpp>
+#include <neonGX/Core/Renderer/OpenGL/Shaders/FontTextureShader.hpp>
+#include <neonGX/Core/Text/FontTextureManager.hpp>
 #include <string>
 #include <vector>
 
 namespace neonGX {
 
   class Text;
+  struct TextGlyphQuad;
+
+  // The glyphs of a text along with everything TextRenderer::Flush needs to
+  // know about the text itself.
+  struct TextRun {
+    const TextGlyphQuad* Glyphs;
+    size_t GlyphCount;
+    FontRenderMode Mode;
+    ColorRGB Color;
+  };
 
   class TextRenderer final : public ObjectRenderer {
   private:
     static constexpr size_t VertexDataCount = 7;
     static constexpr size_t VertexByteSize = VertexDataCount * sizeof(float);
+    // VertexFormat::Compact, position{X, Y} = 2 x float, texture coordinates
+    // = 2 x uint16 (Normalized), Color{R, G, B, A} = 4 x byte (Normalized)
+    static constexpr size_t CompactVertexByteSize = 16;
     static constexpr size_t BatchSize = 2000;
+    // Number of full batches the streaming vertex buffer holds before it
+    // gets orphaned.
+    static constexpr size_t StreamedBatches = 4;
+
+    // A range of glyphs which share an atlas page and render mode.
+    struct TextBatch {
+      size_t Page;
+      FontRenderMode Mode;
+      size_t Start;
+      size_t Size;
+    };
 
     webgl_context_handle m_GLHandle;
     GLRenderer* m_Renderer;
 
+    bool m_CompactVertices = false;
+    size_t m_VertexByteSize = VertexByteSize;
+
     std::vector<uint8_t> m_Vertices;
     std::vector<uint16_t> m_Indices;
 
     std::shared_ptr<GLBuffer> m_VertexBuffer;
     std::shared_ptr<GLBuffer> m_IndexBuffer;
 
-    std::vector<Text*> m_TextObjects;
+    std::vector<TextRun> m_Runs;
+    std::vector<TextBatch> m_Batches;
 
     size_t m_CurrentBatchCount = 0;
 
+    FontTextureShader& UseShader(FontRenderMode mode);
+    void SetVertexAttributes(FontTextureShader& shader, size_t baseOffset);
+
   public:
     explicit TextRenderer(GLRenderer* renderer);
     virtual ~TextRenderer();
@@ -47,6 +81,14 @@ namespace neonGX {
     void Stop() override;
     void Flush() override;
     void Render(DisplayObject* object) override;
+
+    void RenderRun(const TextRun& run);
+
+    // Re-resolves the glyphs living on atlas pages evicted since the quads
+    // were built and marks the other pages as used by the current frame.
+    static void ValidateGlyphs(FontTextureManager& fontManager, Text& text);
+
+    static TextRun GetTextRun(const Text& text);
   };
 
 } // end namespace neonGX
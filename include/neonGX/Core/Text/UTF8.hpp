@@ -0,0 +1,80 @@
+/*
+ * neonGX - UTF8.hpp
+ *
+ * Copyright (c) 2016, cynecx
+ *
+ * This file is part of neonGX and is distributed under a modified
+ * BSD 3-Clause License. See LICENSE.txt for details.
+ *
+ */
+
+#ifndef NEONGX_UTF8_H
+#define NEONGX_UTF8_H
+
+#include <cstdint>
+#include <string>
+
+namespace neonGX {
+
+  static constexpr char32_t ReplacementCharacter = 0xFFFD;
+
+  // Decodes UTF-8, malformed sequences (including overlong encodings and
+  // surrogates) decode to U+FFFD.
+  inline std::u32string DecodeUTF8(const std::string& text) {
+    std::u32string result;
+    result.reserve(text.size());
+
+    size_t i = 0;
+    while(i < text.size()) {
+      uint8_t lead = uint8_t(text[i]);
+
+      size_t length = 0;
+      char32_t codepoint = 0;
+      char32_t minimum = 0;
+
+      if(lead < 0x80) {
+        result.push_back(lead);
+        i++;
+        continue;
+      } else if((lead & 0xE0) == 0xC0) {
+        length = 2;
+        codepoint = lead & 0x1F;
+        minimum = 0x80;
+      } else if((lead & 0xF0) == 0xE0) {
+        length = 3;
+        codepoint = lead & 0x0F;
+        minimum = 0x800;
+      } else if((lead & 0xF8) == 0xF0) {
+        length = 4;
+        codepoint = lead & 0x07;
+        minimum = 0x10000;
+      } else {
+        result.push_back(ReplacementCharacter);
+        i++;
+        continue;
+      }
+
+      size_t consumed = 1;
+      for(; consumed < length && i + consumed < text.size(); consumed++) {
+        uint8_t continuation = uint8_t(text[i + consumed]);
+        if((continuation & 0xC0) != 0x80) {
+          break;
+        }
+        codepoint = (codepoint << 6) | (continuation & 0x3F);
+      }
+
+      if(consumed != length || codepoint < minimum || codepoint > 0x10FFFF ||
+         (codepoint >= 0xD800 && codepoint <= 0xDFFF)) {
+        codepoint = ReplacementCharacter;
+      }
+
+      result.push_back(codepoint);
+      i += consumed;
+    }
+
+    return result;
+  }
+
+} // end namespace neonGX
+
+#endif // !NEONGX_UTF8_H
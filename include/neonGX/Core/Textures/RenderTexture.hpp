@@ -11,10 +11,32 @@
 #ifndef NEONGX_RENDERTEXTURE_H
 #define NEONGX_RENDERTEXTURE_H
 
+#include <neonGX/Core/Math/Primitives.hpp>
+#include <neonGX/Core/Renderer/OpenGL/GLContext.hpp>
+#include <neonGX/Core/Renderer/OpenGL/GLRenderTarget.hpp>
+#include <neonGX/Core/Textures/BaseTexture.hpp>
+#include <neonGX/Core/Textures/Texture.hpp>
+#include <memory>
+
 namespace neonGX {
 
-  class RenderTexture {
+  // A texture backed by a framebuffer, see GLRenderer::RenderToTexture.
+  // It can be used like any other texture, e.g. by a Sprite.
+  class RenderTexture final : public Texture {
+  private:
+    std::unique_ptr<GLRenderTarget> m_RenderTarget;
+
+  public:
+    RenderTexture(webgl_context_handle glHandle, const FSize& size,
+                  float resolution = 1.0f,
+                  ScaleMode scaleMode = ScaleMode::Linear);
+
+    // The contents are undefined afterwards.
+    void Resize(const FSize& size);
 
+    GLRenderTarget& GetRenderTarget() {
+      return *m_RenderTarget;
+    }
   };
 
 } // end namespace neonGX
@@ -60,7 +60,7 @@ namespace neonGX {
       return m_IsValid && m_UVs;
     }
 
-    std::shared_ptr<BaseTexture> GetBaseTexture() {
+    const std::shared_ptr<BaseTexture>& GetBaseTexture() const {
       return m_BaseTexture;
     }
 
@@ -0,0 +1,61 @@
+/*
+ * neonGX - WorkerPool.hpp
+ *
+ * Copyright (c) 2016, cynecx
+ *
+ * This file is part of neonGX and is distributed under a modified
+ * BSD 3-Clause License. See LICENSE.txt for details.
+ *
+ */
+
+#ifndef NEONGX_WORKERPOOL_H
+#define NEONGX_WORKERPOOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace neonGX {
+
+  // Fixed set of threads running submitted jobs in FIFO order. Without
+  // thread support (emscripten builds without pthreads) jobs run inline in
+  // Submit.
+  class WorkerPool {
+  private:
+    std::vector<std::thread> m_Threads;
+    std::deque<std::function<void()>> m_Jobs;
+
+    std::mutex m_Mutex;
+    std::condition_variable m_JobAvailable;
+    bool m_Stopping = false;
+
+    void WorkerLoop();
+
+  public:
+    // 0 picks one thread less than the hardware concurrency, at least one.
+    explicit WorkerPool(size_t threadCount = 0);
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    size_t GetThreadCount() const {
+      return m_Threads.empty() ? 1 : m_Threads.size();
+    }
+
+    void Submit(std::function<void()> job);
+
+    // Splits [0, count) into ranges of a multiple of grain elements, runs
+    // body(begin, end) for each of them on the pool and the calling thread
+    // and returns once all ranges are done.
+    void ParallelFor(size_t count, size_t grain,
+                     const std::function<void(size_t, size_t)>& body);
+  };
+
+} // end namespace neonGX
+
+#endif // !NEONGX_WORKERPOOL_H
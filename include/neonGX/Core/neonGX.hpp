@@ -16,9 +16,13 @@
 
 namespace neonGX {
 
+  class GLRenderer;
+
   void InitializeEngine();
 
-  void RunMainLoop(webgl_context_handle glHandle,
+  // Calls loopCallback once per frame and presents the frames renderer
+  // draws, until its window gets closed.
+  void RunMainLoop(GLRenderer& renderer,
                    std::function<void()> loopCallback);
 
 } // end namespace neonGX
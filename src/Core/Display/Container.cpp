@@ -9,6 +9,12 @@
  */
 
 #include <neonGX/Core/Display/Container.hpp>
+#include <neonGX/Core/Display/SpatialIndex.hpp>
+#include <neonGX/Core/Input/Input.hpp>
+#include <neonGX/Core/Renderer/OpenGL/GLRenderer.hpp>
+#include <neonGX/Core/Sprites/Sprite.hpp>
+#include <neonGX/Core/Textures/RenderTexture.hpp>
+#include <algorithm>
 #include <limits>
 
 namespace neonGX {
@@ -20,6 +26,10 @@ namespace neonGX {
     assert(child.get() != nullptr);
     m_Children.push_back(child);
     DisplayObject::SetRemoteDOParent(child.get());
+
+    if(SpatialIndex* spatialIndex = FindSpatialIndex()) {
+      spatialIndex->OnSubtreeAdded(child.get());
+    }
   }
 
   void Container::AddChildAt(std::shared_ptr<DisplayObject> child,
@@ -28,13 +38,59 @@ namespace neonGX {
     assert(index < m_Children.size());
     m_Children.insert(m_Children.begin() + int(index), child);
     DisplayObject::SetRemoteDOParent(child.get());
+
+    if(SpatialIndex* spatialIndex = FindSpatialIndex()) {
+      spatialIndex->OnSubtreeAdded(child.get());
+    }
   }
 
   void Container::RemoveChild(size_t index) {
     assert(index < m_Children.size());
     auto it = m_Children.begin() + size_t(index);
+
+    if(SpatialIndex* spatialIndex = FindSpatialIndex()) {
+      spatialIndex->OnSubtreeRemoved(it->get());
+    }
+
     DisplayObject::SetRemoteDOParent(it->get(), true);
     m_Children.erase(it);
+
+    m_CacheDirty = true;
+    m_WorldBoundsValid = false;
+    NotifyParentsChanged(nullptr);
+  }
+
+  void Container::OnStateChanged() {
+    m_CacheDirty = true;
+    m_WorldBoundsValid = false;
+
+    // Everything indexed moved along.
+    if(m_SpatialIndex) {
+      m_SpatialIndex->MarkDirty(this);
+    }
+  }
+
+  void Container::OnChildChanged(DisplayObject* origin) {
+    m_CacheDirty = true;
+
+    if(m_SpatialIndex && origin) {
+      m_SpatialIndex->MarkDirty(origin);
+    }
+  }
+
+  void Container::SetSpatialIndexEnabled(bool enabled) {
+    if(enabled == bool(m_SpatialIndex)) {
+      return;
+    }
+
+    if(!enabled) {
+      m_SpatialIndex.reset();
+      return;
+    }
+
+    assert(!(m_Parent && m_Parent->FindSpatialIndex()) &&
+           "Spatial indices can not be nested.");
+    m_SpatialIndex = std::make_unique<SpatialIndex>(this);
   }
 
   std::shared_ptr<DisplayObject>& Container::GetChildAt(size_t index) {
@@ -47,13 +103,46 @@ namespace neonGX {
       return;
     }
 
-    DisplayObject::UpdateTransform(UseDefaultParent);
+    UpdateWorldTransform(UseDefaultParent);
+
+    // Nothing below changed, static subtrees are skipped entirely.
+    if(!m_ChildTransformDirty) {
+      return;
+    }
+    m_ChildTransformDirty = false;
 
     for(auto& child : m_Children) {
       child->UpdateTransform();
     }
   }
 
+  DisplayObject* Container::HitTest(const FPoint& point) {
+    if(!m_Visible || !m_Renderable || m_Alpha <= 0) {
+      return nullptr;
+    }
+
+    if(m_SpatialIndex) {
+      return m_SpatialIndex->HitTest(point);
+    }
+
+    auto bounds = GetCachedWorldBounds();
+    if(bounds && !AABB::FromRectangle(bounds.value()).Contains(point)) {
+      return nullptr;
+    }
+
+    for(auto it = m_Children.rbegin(); it != m_Children.rend(); ++it) {
+      if(DisplayObject* hit = (*it)->HitTest(point)) {
+        return hit;
+      }
+    }
+
+    return nullptr;
+  }
+
+  DisplayObject* Container::HitTest(const InputHandle& input) {
+    return HitTest(FPoint{input.GetMousePosition()});
+  }
+
   NRectangle Container::GetBounds() {
     if(m_Children.size() == 0) {
       return { {0, 0}, {0, 0} };
@@ -96,6 +185,46 @@ namespace neonGX {
     return { {minX, minY}, { maxX - minX, maxY - minY } };
   }
 
+  optional<NRectangle> Container::GetCachedWorldBounds() {
+    if(m_WorldBoundsValid) {
+      return m_WorldBounds;
+    }
+
+    int32_t minX = std::numeric_limits<int32_t>::max();
+    int32_t minY = std::numeric_limits<int32_t>::max();
+    int32_t maxX = std::numeric_limits<int32_t>::min();
+    int32_t maxY = std::numeric_limits<int32_t>::min();
+
+    for(auto& child : m_Children) {
+      if(!child->GetVisible() || child->GetAlpha() <= 0) {
+        continue;
+      }
+
+      auto childBounds = child->GetCachedWorldBounds();
+      if(!childBounds) {
+        return nullopt;
+      }
+
+      if(childBounds->size.width <= 0 || childBounds->size.height <= 0) {
+        continue;
+      }
+
+      minX = std::min(minX, childBounds->point.x);
+      minY = std::min(minY, childBounds->point.y);
+      maxX = std::max(maxX, childBounds->point.x + childBounds->size.width);
+      maxY = std::max(maxY, childBounds->point.y + childBounds->size.height);
+    }
+
+    if(minX > maxX) {
+      m_WorldBounds = { {0, 0}, {0, 0} };
+    } else {
+      m_WorldBounds = { {minX, minY}, {maxX - minX, maxY - minY} };
+    }
+
+    m_WorldBoundsValid = true;
+    return m_WorldBounds;
+  }
+
   NRectangle Container::GetLocalBounds() {
     for(auto& it : m_Children) {
       it->UpdateTransform(true);
@@ -104,6 +233,72 @@ namespace neonGX {
     return GetBounds();
   }
 
+  void Container::SetCacheAsBitmap(bool cacheAsBitmap) {
+    if(cacheAsBitmap == m_CacheAsBitmap) {
+      return;
+    }
+
+    m_CacheAsBitmap = cacheAsBitmap;
+    m_CacheDirty = true;
+
+    // Drawn as a single object from now on, or the other way around.
+    ContentChanged();
+
+    if(SpatialIndex* spatialIndex = FindSpatialIndex()) {
+      spatialIndex->OnRendersChildrenChanged(this);
+    }
+
+    if(!m_CacheAsBitmap) {
+      m_CacheSprite.reset();
+      m_CacheTexture.reset();
+    }
+  }
+
+  void Container::RenderCachedBitmap(GLRenderer* renderer) {
+    if(m_WorldTransform != m_CachedWorldTransform ||
+       m_WorldAlpha != m_CachedWorldAlpha) {
+      m_CacheDirty = true;
+    }
+
+    if(m_CacheDirty) {
+      m_CacheDirty = false;
+      m_CachedWorldTransform = m_WorldTransform;
+      m_CachedWorldAlpha = m_WorldAlpha;
+
+      if(!m_CacheTexture) {
+        m_CacheTexture = std::make_shared<RenderTexture>(
+            renderer->webgl_handle, FSize{1, 1},
+            float(renderer->GetSettings().Resolution));
+      }
+
+      m_RenderingCache = true;
+      FRectangle area = renderer->RenderToTexture(this, *m_CacheTexture);
+      m_RenderingCache = false;
+
+      if(area.size.width <= 0.0f || area.size.height <= 0.0f) {
+        m_CacheSprite.reset();
+        return;
+      }
+
+      if(!m_CacheSprite) {
+        m_CacheSprite = std::make_shared<Sprite>(m_CacheTexture);
+      }
+
+      // The children already carry the world transform and alpha, the
+      // bitmap is placed without a parent.
+      m_CacheSprite->SetPosition(area.point);
+      m_CacheSprite->UpdateTransform(true);
+      m_CacheSprite->StateChanged();
+    }
+
+    if(!m_CacheSprite) {
+      return;
+    }
+
+    m_CacheSprite->SetRenderLayer(GetRenderLayer());
+    m_CacheSprite->RenderWebGL(renderer);
+  }
+
   void Container::RenderWebGL(GLRenderer* renderer) {
     assert(renderer != nullptr);
 
@@ -111,7 +306,26 @@ namespace neonGX {
       return;
     }
 
+    if(m_CacheAsBitmap && !m_RenderingCache &&
+       renderer->CanRenderToTexture()) {
+      RenderCachedBitmap(renderer);
+      return;
+    }
+
+    if(m_SpatialIndex && renderer->GetCullingFrame()) {
+      m_SpatialIndex->QueryVisible(renderer->GetCullingFrame().value(),
+          m_VisibleObjects);
+
+      for(DisplayObject* object : m_VisibleObjects) {
+        object->RenderWebGL(renderer);
+      }
+      return;
+    }
+
     for(auto& it : m_Children) {
+      if(renderer->CullObject(*it)) {
+        continue;
+      }
       it->RenderWebGL(renderer);
     }
   }
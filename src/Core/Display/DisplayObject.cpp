@@ -10,6 +10,7 @@
 
 #include <neonGX/Core/Display/DisplayObject.hpp>
 #include <neonGX/Core/Display/Container.hpp>
+#include <neonGX/Core/Display/DynamicAABBTree.hpp>
 
 namespace neonGX {
 
@@ -17,20 +18,118 @@ namespace neonGX {
   DisplayObject::~DisplayObject() = default;
 
   void DisplayObject::UpdateTransform(bool UseIdentityTransform) {
-    m_LocalTransform = GetSkewingMatrix(m_Skew) *
-                       GetTranslationMatrix(m_Position) *
-                       GetTranslationMatrix(m_Pivot) *
-                       GetRotationMatrix(m_Rotation) *
-                       GetScalingMatrix(m_Scale) *
-                       GetTranslationMatrix(m_Pivot.Neg());
-
-    if(m_Parent && !UseIdentityTransform) {
-      m_WorldTransform = m_LocalTransform * m_Parent->m_LocalTransform;
-      m_WorldAlpha = m_Alpha * m_Parent->m_Alpha;
+    UpdateWorldTransform(UseIdentityTransform);
+  }
+
+  void DisplayObject::UpdateWorldTransform(bool UseIdentityTransform) {
+    if(m_LocalTransformDirty) {
+      m_LocalTransformDirty = false;
+      m_WorldTransformDirty = true;
+      m_LocalTransform = GetLocalTransform(m_Position, m_Scale, m_Pivot,
+          m_Skew, m_Rotation);
+    }
+
+    DisplayObject* parent = UseIdentityTransform ? nullptr : m_Parent;
+    if(parent != m_TransformParent ||
+       (parent && parent->m_WorldVersion != m_ParentWorldVersion)) {
+      m_WorldTransformDirty = true;
+    }
+
+    if(!m_WorldTransformDirty) {
+      return;
+    }
+
+    m_WorldTransformDirty = false;
+    m_TransformParent = parent;
+
+    Affine2D worldTransform;
+    float worldAlpha;
+    if(parent) {
+      m_ParentWorldVersion = parent->m_WorldVersion;
+      worldTransform = parent->m_WorldTransform * m_LocalTransform;
+      worldAlpha = m_Alpha * parent->m_WorldAlpha;
     } else {
-      m_WorldTransform = m_LocalTransform * GetIdentityTransform();
-      m_WorldAlpha = m_Alpha;
+      worldTransform = m_LocalTransform;
+      worldAlpha = m_Alpha;
+    }
+
+    bool transformChanged = worldTransform != m_WorldTransform;
+    if(!transformChanged && worldAlpha == m_WorldAlpha) {
+      return;
+    }
+
+    m_WorldAlpha = worldAlpha;
+    m_WorldVersion++;
+    m_ChildTransformDirty = true;
+    MarkRenderChanged();
+
+    if(transformChanged) {
+      m_WorldTransform = worldTransform;
+      m_InverseWorldTransformValid = false;
+      m_WorldBoundsValid = false;
+      OnWorldTransformChanged();
+    }
+  }
+
+  void DisplayObject::UpdateTransformPath() {
+    if(m_Parent) {
+      m_Parent->UpdateTransformPath();
+    }
+    UpdateWorldTransform(false);
+  }
+
+  const optional<Affine2D>& DisplayObject::GetInverseWorldTransform() {
+    if(!m_InverseWorldTransformValid) {
+      m_InverseWorldTransformValid = true;
+
+      if(!m_WorldTransform.IsInvertible()) {
+        m_InverseWorldTransform = nullopt;
+      } else {
+        m_InverseWorldTransform = m_WorldTransform.GetInverse();
+      }
     }
+
+    return m_InverseWorldTransform;
+  }
+
+  DisplayObject* DisplayObject::HitTest(const FPoint& point) {
+    if(!m_Visible || !m_Renderable || m_Alpha <= 0) {
+      return nullptr;
+    }
+
+    // Rejects most misses without touching the inverse transform.
+    if(m_WorldBoundsValid &&
+       !AABB::FromRectangle(m_WorldBounds).Contains(point)) {
+      return nullptr;
+    }
+
+    const auto& inverse = GetInverseWorldTransform();
+    if(!inverse) {
+      return nullptr;
+    }
+
+    if(!HitTestLocal(inverse->Apply(point))) {
+      return nullptr;
+    }
+
+    return this;
+  }
+
+  void DisplayObject::NotifyParentsChanged(DisplayObject* origin) {
+    for(DisplayObject* obj = m_Parent; obj != nullptr; obj = obj->m_Parent) {
+      obj->m_WorldBoundsValid = false;
+      obj->OnChildChanged(origin);
+    }
+  }
+
+  SpatialIndex* DisplayObject::FindSpatialIndex() {
+    for(DisplayObject* obj = this; obj != nullptr; obj = obj->m_Parent) {
+      if(SpatialIndex* index = obj->GetSpatialIndex()) {
+        return index;
+      }
+    }
+
+    return nullptr;
   }
 
   bool DisplayObject::IsVisible() const {
@@ -48,8 +147,10 @@ namespace neonGX {
   }
 
   FPoint DisplayObject::ToGlobalPosition(const FPoint& position) {
-    UpdateTransform();
-    return ApplyTransformation(m_WorldTransform, position);
+    // Only the transforms down to this object are needed, not the ones of
+    // its children.
+    UpdateTransformPath();
+    return m_WorldTransform.Apply(position);
   }
 
   FPoint DisplayObject::ToLocalPosition(const FPoint& position,
@@ -61,8 +162,13 @@ namespace neonGX {
       newPos = position;
     }
 
-    UpdateTransform();
-    return ApplyInverseTransformation(m_WorldTransform, newPos);
+    UpdateTransformPath();
+
+    const auto& inverse = GetInverseWorldTransform();
+    if(!inverse) {
+      return {};
+    }
+    return inverse->Apply(newPos);
   }
 
 }
@@ -0,0 +1,268 @@
+/*
+ * neonGX - DynamicAABBTree.cpp
+ *
+ * Copyright (c) 2016, cynecx
+ *
+ * This file is part of neonGX and is distributed under a modified
+ * BSD 3-Clause License. See LICENSE.txt for details.
+ *
+ */
+
+#include <neonGX/Core/Display/DynamicAABBTree.hpp>
+
+namespace neonGX {
+
+  int32_t DynamicAABBTree::AllocateNode() {
+    if(m_FreeList == NullNode) {
+      m_Nodes.emplace_back();
+      return int32_t(m_Nodes.size() - 1);
+    }
+
+    int32_t node = m_FreeList;
+    m_FreeList = m_Nodes[size_t(node)].Parent;
+    m_Nodes[size_t(node)] = Node{};
+    return node;
+  }
+
+  void DynamicAABBTree::FreeNode(int32_t node) {
+    m_Nodes[size_t(node)] = Node{};
+    m_Nodes[size_t(node)].Parent = m_FreeList;
+    m_FreeList = node;
+  }
+
+  int32_t DynamicAABBTree::CreateProxy(const AABB& bounds,
+                                       DisplayObject* object) {
+    int32_t proxy = AllocateNode();
+
+    Node& node = m_Nodes[size_t(proxy)];
+    node.Bounds = AABB{
+        bounds.MinX - m_Margin, bounds.MinY - m_Margin,
+        bounds.MaxX + m_Margin, bounds.MaxY + m_Margin
+    };
+    node.Object = object;
+    node.Height = 0;
+
+    InsertLeaf(proxy);
+    m_ProxyCount++;
+
+    return proxy;
+  }
+
+  void DynamicAABBTree::DestroyProxy(int32_t proxy) {
+    assert(proxy >= 0 && size_t(proxy) < m_Nodes.size());
+    assert(m_Nodes[size_t(proxy)].IsLeaf());
+
+    RemoveLeaf(proxy);
+    FreeNode(proxy);
+    m_ProxyCount--;
+  }
+
+  bool DynamicAABBTree::MoveProxy(int32_t proxy, const AABB& bounds) {
+    assert(proxy >= 0 && size_t(proxy) < m_Nodes.size());
+    assert(m_Nodes[size_t(proxy)].IsLeaf());
+
+    if(m_Nodes[size_t(proxy)].Bounds.Contains(bounds)) {
+      return false;
+    }
+
+    RemoveLeaf(proxy);
+
+    m_Nodes[size_t(proxy)].Bounds = AABB{
+        bounds.MinX - m_Margin, bounds.MinY - m_Margin,
+        bounds.MaxX + m_Margin, bounds.MaxY + m_Margin
+    };
+
+    InsertLeaf(proxy);
+    return true;
+  }
+
+  void DynamicAABBTree::InsertLeaf(int32_t leaf) {
+    if(m_Root == NullNode) {
+      m_Root = leaf;
+      m_Nodes[size_t(m_Root)].Parent = NullNode;
+      return;
+    }
+
+    AABB leafBounds = m_Nodes[size_t(leaf)].Bounds;
+
+    // Descends towards the sibling which grows the total perimeter of the
+    // tree the least.
+    int32_t index = m_Root;
+    while(!m_Nodes[size_t(index)].IsLeaf()) {
+      const Node& node = m_Nodes[size_t(index)];
+
+      float perimeter = node.Bounds.GetPerimeter();
+      float combinedPerimeter =
+          AABB::Union(node.Bounds, leafBounds).GetPerimeter();
+
+      // Pairing the leaf with this node.
+      float cost = 2.0f * combinedPerimeter;
+      // Pushing the leaf further down grows this node in any case.
+      float inheritanceCost = 2.0f * (combinedPerimeter - perimeter);
+
+      auto descendCost = [&](int32_t child) {
+        const Node& childNode = m_Nodes[size_t(child)];
+        float grown = AABB::Union(childNode.Bounds, leafBounds)
+            .GetPerimeter();
+        if(!childNode.IsLeaf()) {
+          grown -= childNode.Bounds.GetPerimeter();
+        }
+        return grown + inheritanceCost;
+      };
+
+      float cost1 = descendCost(node.Child1);
+      float cost2 = descendCost(node.Child2);
+
+      if(cost < cost1 && cost < cost2) {
+        break;
+      }
+
+      index = cost1 < cost2 ? node.Child1 : node.Child2;
+    }
+
+    int32_t sibling = index;
+    int32_t oldParent = m_Nodes[size_t(sibling)].Parent;
+    int32_t newParent = AllocateNode();
+
+    Node& parentNode = m_Nodes[size_t(newParent)];
+    parentNode.Parent = oldParent;
+    parentNode.Bounds = AABB::Union(leafBounds,
+        m_Nodes[size_t(sibling)].Bounds);
+    parentNode.Height = m_Nodes[size_t(sibling)].Height + 1;
+    parentNode.Child1 = sibling;
+    parentNode.Child2 = leaf;
+
+    if(oldParent != NullNode) {
+      Node& oldParentNode = m_Nodes[size_t(oldParent)];
+      if(oldParentNode.Child1 == sibling) {
+        oldParentNode.Child1 = newParent;
+      } else {
+        oldParentNode.Child2 = newParent;
+      }
+    } else {
+      m_Root = newParent;
+    }
+
+    m_Nodes[size_t(sibling)].Parent = newParent;
+    m_Nodes[size_t(leaf)].Parent = newParent;
+
+    Refit(m_Nodes[size_t(leaf)].Parent);
+  }
+
+  void DynamicAABBTree::RemoveLeaf(int32_t leaf) {
+    if(leaf == m_Root) {
+      m_Root = NullNode;
+      return;
+    }
+
+    int32_t parent = m_Nodes[size_t(leaf)].Parent;
+    int32_t grandParent = m_Nodes[size_t(parent)].Parent;
+    int32_t sibling = m_Nodes[size_t(parent)].Child1 == leaf
+        ? m_Nodes[size_t(parent)].Child2
+        : m_Nodes[size_t(parent)].Child1;
+
+    FreeNode(parent);
+
+    if(grandParent == NullNode) {
+      m_Root = sibling;
+      m_Nodes[size_t(sibling)].Parent = NullNode;
+      return;
+    }
+
+    Node& grandParentNode = m_Nodes[size_t(grandParent)];
+    if(grandParentNode.Child1 == parent) {
+      grandParentNode.Child1 = sibling;
+    } else {
+      grandParentNode.Child2 = sibling;
+    }
+    m_Nodes[size_t(sibling)].Parent = grandParent;
+
+    Refit(grandParent);
+  }
+
+  void DynamicAABBTree::Refit(int32_t node) {
+    for(int32_t index = node; index != NullNode;) {
+      index = Balance(index);
+
+      Node& current = m_Nodes[size_t(index)];
+      const Node& child1 = m_Nodes[size_t(current.Child1)];
+      const Node& child2 = m_Nodes[size_t(current.Child2)];
+
+      current.Height = 1 + std::max(child1.Height, child2.Height);
+      current.Bounds = AABB::Union(child1.Bounds, child2.Bounds);
+
+      index = current.Parent;
+    }
+  }
+
+  int32_t DynamicAABBTree::Balance(int32_t iA) {
+    Node& a = m_Nodes[size_t(iA)];
+    if(a.IsLeaf() || a.Height < 2) {
+      return iA;
+    }
+
+    int32_t iB = a.Child1;
+    int32_t iC = a.Child2;
+    Node& b = m_Nodes[size_t(iB)];
+    Node& c = m_Nodes[size_t(iC)];
+
+    int32_t balance = c.Height - b.Height;
+
+    // Rotates the taller child up, it takes the place of A and A takes the
+    // place of its shorter grandchild.
+    auto rotateUp = [&](int32_t iUp, Node& up, Node& other,
+                        bool upIsChild2) {
+      int32_t iF = up.Child1;
+      int32_t iG = up.Child2;
+      Node& f = m_Nodes[size_t(iF)];
+      Node& g = m_Nodes[size_t(iG)];
+
+      up.Child1 = iA;
+      up.Parent = a.Parent;
+      a.Parent = iUp;
+
+      if(up.Parent != NullNode) {
+        Node& parent = m_Nodes[size_t(up.Parent)];
+        if(parent.Child1 == iA) {
+          parent.Child1 = iUp;
+        } else {
+          parent.Child2 = iUp;
+        }
+      } else {
+        m_Root = iUp;
+      }
+
+      int32_t iKeep = f.Height > g.Height ? iF : iG;
+      int32_t iMove = f.Height > g.Height ? iG : iF;
+      Node& keep = m_Nodes[size_t(iKeep)];
+      Node& move = m_Nodes[size_t(iMove)];
+
+      up.Child2 = iKeep;
+      if(upIsChild2) {
+        a.Child2 = iMove;
+      } else {
+        a.Child1 = iMove;
+      }
+      move.Parent = iA;
+
+      a.Bounds = AABB::Union(other.Bounds, move.Bounds);
+      up.Bounds = AABB::Union(a.Bounds, keep.Bounds);
+
+      a.Height = 1 + std::max(other.Height, move.Height);
+      up.Height = 1 + std::max(a.Height, keep.Height);
+
+      return iUp;
+    };
+
+    if(balance > 1) {
+      return rotateUp(iC, c, b, true);
+    }
+
+    if(balance < -1) {
+      return rotateUp(iB, b, c, false);
+    }
+
+    return iA;
+  }
+
+}
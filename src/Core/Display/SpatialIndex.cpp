@@ -0,0 +1,298 @@
+/*
+ * neonGX - SpatialIndex.cpp
+ *
+ * Copyright (c) 2016, cynecx
+ *
+ * This file is part of neonGX and is distributed under a modified
+ * BSD 3-Clause License. See LICENSE.txt for details.
+ *
+ */
+
+#include <neonGX/Core/Display/SpatialIndex.hpp>
+#include <neonGX/Core/Display/Container.hpp>
+#include <algorithm>
+#include <utility>
+
+namespace neonGX {
+
+  SpatialIndex::SpatialIndex(Container* root) : m_Root(root) {
+    assert(root != nullptr);
+    MarkDirty(root);
+  }
+
+  SpatialIndex::~SpatialIndex() {
+    RemoveDescendants(m_Root);
+
+    for(DisplayObject* object : m_Dirty) {
+      object->m_SpatialDirtyIndex = -1;
+    }
+  }
+
+  void SpatialIndex::MarkDirty(DisplayObject* object) {
+    if(object->m_SpatialDirtyIndex < 0) {
+      object->m_SpatialDirtyIndex = int32_t(m_Dirty.size());
+      m_Dirty.push_back(object);
+    }
+  }
+
+  void SpatialIndex::Unqueue(DisplayObject* object) {
+    int32_t index = object->m_SpatialDirtyIndex;
+    if(index < 0) {
+      return;
+    }
+
+    DisplayObject* last = m_Dirty.back();
+    m_Dirty[size_t(index)] = last;
+    last->m_SpatialDirtyIndex = index;
+
+    m_Dirty.pop_back();
+    object->m_SpatialDirtyIndex = -1;
+  }
+
+  bool SpatialIndex::IsSelfDrawn(const DisplayObject* object) {
+    return object->m_Visible && object->m_Renderable && object->m_Alpha > 0;
+  }
+
+  bool SpatialIndex::IsDrawn(const DisplayObject* object) const {
+    for(; object != nullptr; object = object->m_Parent) {
+      if(!IsSelfDrawn(object)) {
+        return false;
+      }
+
+      if(object == m_Root) {
+        return true;
+      }
+    }
+
+    // Not part of the subtree anymore.
+    return false;
+  }
+
+  void SpatialIndex::OnSubtreeAdded(DisplayObject* object) {
+    MarkDirty(object);
+    m_OrderDirty = true;
+  }
+
+  void SpatialIndex::OnSubtreeRemoved(DisplayObject* object) {
+    RemoveObject(object);
+    RemoveDescendants(object);
+  }
+
+  void SpatialIndex::OnRendersChildrenChanged(DisplayObject* object) {
+    // Descendants of objects drawing their own subtree are not numbered.
+    MarkDirty(object);
+    m_OrderDirty = true;
+  }
+
+  void SpatialIndex::RemoveObject(DisplayObject* object) {
+    if(object->m_SpatialProxy != DynamicAABBTree::NullNode) {
+      m_Tree.DestroyProxy(object->m_SpatialProxy);
+      object->m_SpatialProxy = DynamicAABBTree::NullNode;
+    }
+
+    Unqueue(object);
+    m_Unbounded.erase(object);
+  }
+
+  void SpatialIndex::RemoveDescendants(DisplayObject* object) {
+    // Only containers have children, whether they draw them or not.
+    auto* container = dynamic_cast<Container*>(object);
+    if(!container) {
+      return;
+    }
+
+    for(auto& child : container->m_Children) {
+      RemoveObject(child.get());
+      RemoveDescendants(child.get());
+    }
+  }
+
+  void SpatialIndex::SyncObject(DisplayObject* object, bool drawn) {
+    if(!drawn) {
+      RemoveObject(object);
+      return;
+    }
+
+    auto bounds = object->GetCachedWorldBounds();
+    if(!bounds && m_ComputeBounds) {
+      object->GetBounds();
+      bounds = object->GetCachedWorldBounds();
+    }
+
+    if(!bounds) {
+      if(object->m_SpatialProxy != DynamicAABBTree::NullNode) {
+        m_Tree.DestroyProxy(object->m_SpatialProxy);
+        object->m_SpatialProxy = DynamicAABBTree::NullNode;
+      }
+      m_Unbounded.insert(object);
+      return;
+    }
+
+    m_Unbounded.erase(object);
+
+    AABB aabb = AABB::FromRectangle(bounds.value());
+    if(object->m_SpatialProxy == DynamicAABBTree::NullNode) {
+      object->m_SpatialProxy = m_Tree.CreateProxy(aabb, object);
+    } else {
+      m_Tree.MoveProxy(object->m_SpatialProxy, aabb);
+    }
+  }
+
+  void SpatialIndex::SyncSubtree(DisplayObject* object, bool parentDrawn) {
+    bool drawn = parentDrawn && IsSelfDrawn(object);
+
+    if(object != m_Root && !object->RendersChildren()) {
+      SyncObject(object, drawn);
+      RemoveDescendants(object);
+      return;
+    }
+
+    RemoveObject(object);
+
+    // RendersChildren only holds for containers.
+    auto* container = static_cast<Container*>(object);
+    for(auto& child : container->m_Children) {
+      SyncSubtree(child.get(), drawn);
+    }
+  }
+
+  void SpatialIndex::UpdateDrawOrder() {
+    uint32_t order = 0;
+
+    std::vector<DisplayObject*> stack{m_Root};
+    while(!stack.empty()) {
+      DisplayObject* object = stack.back();
+      stack.pop_back();
+
+      object->m_DrawOrder = order++;
+
+      if(object->RendersChildren()) {
+        auto* container = static_cast<Container*>(object);
+        for(auto it = container->m_Children.rbegin();
+            it != container->m_Children.rend(); ++it) {
+          stack.push_back(it->get());
+        }
+      }
+    }
+  }
+
+  void SpatialIndex::Update() {
+    Update(false);
+  }
+
+  void SpatialIndex::Update(bool computeBounds) {
+    m_ComputeBounds = computeBounds;
+
+    // Unknown bounds are usually computed by the frame that drew them.
+    for(DisplayObject* object : m_Unbounded) {
+      MarkDirty(object);
+    }
+
+    m_Syncing.swap(m_Dirty);
+    for(DisplayObject* object : m_Syncing) {
+      object->m_SpatialDirtyIndex = -1;
+    }
+
+    for(DisplayObject* object : m_Syncing) {
+      if(object == m_Root) {
+        SyncSubtree(m_Root, true);
+        continue;
+      }
+
+      // Changes below an object drawing its own subtree re-index that
+      // object instead.
+      DisplayObject* target = object;
+      for(DisplayObject* parent = object->m_Parent;
+          parent != nullptr && parent != m_Root; parent = parent->m_Parent) {
+        if(!parent->RendersChildren()) {
+          target = parent;
+        }
+      }
+
+      SyncSubtree(target, IsDrawn(target->m_Parent));
+    }
+
+    m_Syncing.clear();
+
+    if(m_OrderDirty) {
+      m_OrderDirty = false;
+      UpdateDrawOrder();
+    }
+  }
+
+  void SpatialIndex::Collect(const AABB& bounds,
+                             std::vector<DisplayObject*>& results) const {
+    results.assign(m_Unbounded.begin(), m_Unbounded.end());
+    m_Tree.Query(bounds, [&](int32_t proxy) {
+      results.push_back(m_Tree.GetObject(proxy));
+    });
+  }
+
+  void SpatialIndex::QueryRect(const FRectangle& rect,
+                               std::vector<DisplayObject*>& results) {
+    Update();
+    Collect(AABB::FromRectangle(rect), results);
+  }
+
+  void SpatialIndex::QueryPoint(const FPoint& point,
+                                std::vector<DisplayObject*>& results) {
+    Update();
+    Collect(AABB{point.x, point.y, point.x, point.y}, results);
+  }
+
+  void SpatialIndex::Raycast(const FPoint& from, const FPoint& to,
+                             std::vector<DisplayObject*>& results) {
+    Update();
+
+    std::vector<std::pair<float, DisplayObject*>> hits;
+    for(DisplayObject* object : m_Unbounded) {
+      hits.emplace_back(0.0f, object);
+    }
+
+    m_Tree.Raycast(from, to, [&](int32_t proxy, float fraction) {
+      hits.emplace_back(fraction, m_Tree.GetObject(proxy));
+    });
+
+    std::stable_sort(hits.begin(), hits.end(),
+        [](const std::pair<float, DisplayObject*>& lhs,
+           const std::pair<float, DisplayObject*>& rhs) {
+          return lhs.first < rhs.first;
+        });
+
+    results.clear();
+    for(const auto& hit : hits) {
+      results.push_back(hit.second);
+    }
+  }
+
+  DisplayObject* SpatialIndex::HitTest(const FPoint& point) {
+    QueryPoint(point, m_HitCandidates);
+
+    std::sort(m_HitCandidates.begin(), m_HitCandidates.end(),
+        [](const DisplayObject* lhs, const DisplayObject* rhs) {
+          return lhs->m_DrawOrder > rhs->m_DrawOrder;
+        });
+
+    for(DisplayObject* object : m_HitCandidates) {
+      if(DisplayObject* hit = object->HitTest(point)) {
+        return hit;
+      }
+    }
+
+    return nullptr;
+  }
+
+  void SpatialIndex::QueryVisible(const FRectangle& frame,
+                                  std::vector<DisplayObject*>& results) {
+    // World transforms are current while rendering, the geometry of
+    // changed objects can be brought up to date right away.
+    Update(true);
+    Collect(AABB::FromRectangle(frame), results);
+
+    std::sort(results.begin(), results.end(),
+        [](const DisplayObject* lhs, const DisplayObject* rhs) {
+          return lhs->m_DrawOrder < rhs->m_DrawOrder;
+        });
+  }
+
+}
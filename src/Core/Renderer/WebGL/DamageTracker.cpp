@@ -0,0 +1,174 @@
+/*
+ * neonGX - DamageTracker.cpp
+ *
+ * Copyright (c) 2016, cynecx
+ *
+ * This file is part of neonGX and is distributed under a modified
+ * BSD 3-Clause License. See LICENSE.txt for details.
+ *
+ */
+
+#include <neonGX/Core/Renderer/OpenGL/DamageTracker.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+
+namespace neonGX {
+
+  static int64_t GetArea(const NRectangle& rect) {
+    return int64_t(rect.size.width) * int64_t(rect.size.height);
+  }
+
+  static NRectangle GetUnion(const NRectangle& a, const NRectangle& b) {
+    int32_t x0 = std::min(a.point.x, b.point.x);
+    int32_t y0 = std::min(a.point.y, b.point.y);
+    int32_t x1 = std::max(a.point.x + a.size.width,
+                          b.point.x + b.size.width);
+    int32_t y1 = std::max(a.point.y + a.size.height,
+                          b.point.y + b.size.height);
+    return { {x0, y0}, {x1 - x0, y1 - y0} };
+  }
+
+  static NRectangle GetIntersection(const NRectangle& a,
+                                    const NRectangle& b) {
+    int32_t x0 = std::max(a.point.x, b.point.x);
+    int32_t y0 = std::max(a.point.y, b.point.y);
+    int32_t x1 = std::min(a.point.x + a.size.width,
+                          b.point.x + b.size.width);
+    int32_t y1 = std::min(a.point.y + a.size.height,
+                          b.point.y + b.size.height);
+    if(x1 <= x0 || y1 <= y0) {
+      return { {0, 0}, {0, 0} };
+    }
+    return { {x0, y0}, {x1 - x0, y1 - y0} };
+  }
+
+  static bool ContainsRect(const NRectangle& outer,
+                           const NRectangle& inner) {
+    return inner.point.x >= outer.point.x &&
+           inner.point.y >= outer.point.y &&
+           inner.point.x + inner.size.width <=
+               outer.point.x + outer.size.width &&
+           inner.point.y + inner.size.height <=
+               outer.point.y + outer.size.height;
+  }
+
+  void DamageTracker::AddRect(std::vector<NRectangle>& rects,
+                              NRectangle rect) {
+    if(rect.size.width <= 0 || rect.size.height <= 0) {
+      return;
+    }
+
+    for(const NRectangle& existing : rects) {
+      if(ContainsRect(existing, rect)) {
+        return;
+      }
+    }
+
+    rects.erase(std::remove_if(rects.begin(), rects.end(),
+        [&rect](const NRectangle& existing) {
+          return ContainsRect(rect, existing);
+        }), rects.end());
+
+    rects.push_back(rect);
+    if(rects.size() <= MaxRects) {
+      return;
+    }
+
+    // Merges the pair whose union covers the least area outside of the
+    // two, overlapping pairs first.
+    size_t bestFirst = 0;
+    size_t bestSecond = 1;
+    int64_t bestCost = std::numeric_limits<int64_t>::max();
+
+    for(size_t i = 0; i < rects.size(); i++) {
+      for(size_t j = i + 1; j < rects.size(); j++) {
+        int64_t cost = GetArea(GetUnion(rects[i], rects[j])) -
+                       GetArea(rects[i]) - GetArea(rects[j]);
+        if(cost < bestCost) {
+          bestCost = cost;
+          bestFirst = i;
+          bestSecond = j;
+        }
+      }
+    }
+
+    rects[bestFirst] = GetUnion(rects[bestFirst], rects[bestSecond]);
+    rects.erase(rects.begin() + std::ptrdiff_t(bestSecond));
+  }
+
+  void DamageTracker::Track(const DisplayObject* object,
+                            const NRectangle& bounds,
+                            const Affine2D& worldTransform, float worldAlpha,
+                            bool changed) {
+    Entry entry{bounds, worldTransform, worldAlpha};
+
+    auto it = m_Previous.find(object);
+    if(it == m_Previous.end()) {
+      AddRect(m_FrameRects, bounds);
+    } else {
+      const Entry& previous = it->second;
+      if(changed || previous.Bounds != bounds ||
+         previous.Transform != entry.Transform ||
+         previous.Alpha != entry.Alpha) {
+        AddRect(m_FrameRects, previous.Bounds);
+        AddRect(m_FrameRects, bounds);
+      }
+
+      // Whatever is left over at the end of the frame was not drawn.
+      m_Previous.erase(it);
+    }
+
+    m_Current[object] = entry;
+  }
+
+  void DamageTracker::EndFrame(const NRectangle& viewport) {
+    for(const auto& removed : m_Previous) {
+      AddRect(m_FrameRects, removed.second.Bounds);
+    }
+
+    m_Previous.swap(m_Current);
+    m_Current.clear();
+
+    if(m_FullDamage) {
+      m_FullDamage = false;
+      m_FrameRects.assign(1, viewport);
+    }
+
+    for(NRectangle& rect : m_FrameRects) {
+      rect = GetIntersection(rect, viewport);
+    }
+
+    m_FrameRects.erase(std::remove_if(m_FrameRects.begin(),
+        m_FrameRects.end(), [](const NRectangle& rect) {
+          return rect.size.width <= 0 || rect.size.height <= 0;
+        }), m_FrameRects.end());
+
+    m_Rects.clear();
+
+    // Skipped frames leave all buffers as they are.
+    if(m_FrameRects.empty()) {
+      return;
+    }
+
+    // Presented frames were drawn into other buffers, their damage is
+    // missing from this one. Buffers older than the history get redrawn.
+    if(m_BufferAge == 0 || m_BufferAge > m_History.size() + 1) {
+      m_Rects.assign(1, viewport);
+    } else {
+      m_Rects = m_FrameRects;
+      for(size_t i = 0; i + 1 < m_BufferAge; i++) {
+        for(const NRectangle& rect : m_History[i]) {
+          AddRect(m_Rects, rect);
+        }
+      }
+    }
+
+    if(m_History.size() == MaxBufferAge - 1) {
+      m_History.pop_back();
+    }
+    m_History.insert(m_History.begin(), m_FrameRects);
+    m_FrameRects.clear();
+  }
+
+}
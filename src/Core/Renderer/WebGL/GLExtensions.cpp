@@ -0,0 +1,159 @@
+/*
+ * neonGX - GLExtensions.cpp
+ *
+ * Copyright (c) 2016, cynecx
+ *
+ * This file is part of neonGX and is distributed under a modified
+ * BSD 3-Clause License. See LICENSE.txt for details.
+ *
+ */
+
+#include <neonGX/Core/Renderer/OpenGL/GLExtensions.hpp>
+#include <cassert>
+#include <cstring>
+
+#ifdef NEONGX_USE_EMSCRIPTEN
+#define GL_GLEXT_PROTOTYPES
+#include <GLES2/gl2ext.h>
+#endif
+
+#if !defined(NEONGX_USE_EMSCRIPTEN) && defined(__linux__)
+// GLX entry points of the libGL the engine links against. The X11 and GLX
+// headers clash with the GL headers included above, the handles are passed
+// around opaquely instead.
+extern "C" {
+  void* glXGetCurrentDisplay();
+  void* glXGetCurrentContext();
+  unsigned long glXGetCurrentDrawable();
+  int glXQueryContext(void* display, void* context, int attribute,
+                      int* value);
+  const char* glXQueryExtensionsString(void* display, int screen);
+  void glXQueryDrawable(void* display, unsigned long drawable, int attribute,
+                        unsigned int* value);
+}
+
+#define NEONGX_GLX_BUFFER_AGE
+#endif
+
+namespace neonGX {
+
+#ifdef NEONGX_GLX_BUFFER_AGE
+  enum : int {
+    GLX_SCREEN = 0x800C,
+    GLX_BACK_BUFFER_AGE_EXT = 0x20F4
+  };
+
+  // Whether the space separated list contains the extension.
+  static bool HasExtension(const char* extensions, const char* name) {
+    if(!extensions) {
+      return false;
+    }
+
+    size_t length = std::strlen(name);
+    while(*extensions) {
+      size_t tokenLength = std::strcspn(extensions, " ");
+      if(tokenLength == length &&
+         std::strncmp(extensions, name, length) == 0) {
+        return true;
+      }
+
+      extensions += tokenLength;
+      extensions += std::strspn(extensions, " ");
+    }
+
+    return false;
+  }
+#endif
+
+  GLExtensions::GLExtensions(webgl_context_handle glHandle)
+      : m_GLHandle(glHandle) {
+    WebGLContextRAII switchCtx(m_GLHandle);
+
+#ifdef NEONGX_USE_EMSCRIPTEN
+    // The context is created with enableExtensionsByDefault = false.
+    m_InstancedArrays = emscripten_webgl_enable_extension(
+        m_GLHandle, "ANGLE_instanced_arrays") == EM_TRUE;
+    m_StandardDerivatives = emscripten_webgl_enable_extension(
+        m_GLHandle, "OES_standard_derivatives") == EM_TRUE;
+#else
+    m_StandardDerivatives = true;
+
+    m_DrawElementsInstanced = reinterpret_cast<PFNGLDRAWELEMENTSINSTANCEDPROC>(
+        glfwGetProcAddress("glDrawElementsInstanced"));
+    m_VertexAttribDivisor = reinterpret_cast<PFNGLVERTEXATTRIBDIVISORPROC>(
+        glfwGetProcAddress("glVertexAttribDivisor"));
+
+    if(!m_DrawElementsInstanced || !m_VertexAttribDivisor) {
+      m_DrawElementsInstanced =
+          reinterpret_cast<PFNGLDRAWELEMENTSINSTANCEDPROC>(
+              glfwGetProcAddress("glDrawElementsInstancedARB"));
+      m_VertexAttribDivisor = reinterpret_cast<PFNGLVERTEXATTRIBDIVISORPROC>(
+          glfwGetProcAddress("glVertexAttribDivisorARB"));
+    }
+
+    m_InstancedArrays = m_DrawElementsInstanced && m_VertexAttribDivisor;
+
+#ifdef NEONGX_GLX_BUFFER_AGE
+    // Contexts created through EGL have no current GLX context. Unknown
+    // drawable attributes raise an X error, the extension is checked once.
+    void* display = glXGetCurrentDisplay();
+    void* context = glXGetCurrentContext();
+    if(display && context) {
+      int screen = 0;
+      glXQueryContext(display, context, GLX_SCREEN, &screen);
+      m_BufferAge = HasExtension(
+          glXQueryExtensionsString(display, screen), "GLX_EXT_buffer_age");
+    }
+#endif
+#endif
+  }
+
+  void GLExtensions::DrawElementsInstanced(GLenum mode, GLsizei count,
+                                           GLenum type, const void* indices,
+                                           GLsizei instances) const {
+    assert(m_InstancedArrays);
+
+    WebGLContextRAII switchCtx(m_GLHandle);
+
+#ifdef NEONGX_USE_EMSCRIPTEN
+    glDrawElementsInstancedANGLE(mode, count, type, indices, instances);
+#else
+    m_DrawElementsInstanced(mode, count, type, indices, instances);
+#endif
+  }
+
+  void GLExtensions::VertexAttribDivisor(GLuint index, GLuint divisor) const {
+    assert(m_InstancedArrays);
+
+    WebGLContextRAII switchCtx(m_GLHandle);
+
+#ifdef NEONGX_USE_EMSCRIPTEN
+    glVertexAttribDivisorANGLE(index, divisor);
+#else
+    m_VertexAttribDivisor(index, divisor);
+#endif
+  }
+
+  size_t GLExtensions::GetBufferAge() const {
+#ifdef NEONGX_GLX_BUFFER_AGE
+    if(!m_BufferAge) {
+      return 0;
+    }
+
+    WebGLContextRAII switchCtx(m_GLHandle);
+
+    void* display = glXGetCurrentDisplay();
+    unsigned long drawable = glXGetCurrentDrawable();
+    if(!display || !drawable) {
+      return 0;
+    }
+
+    unsigned int age = 0;
+    glXQueryDrawable(display, drawable, GLX_BACK_BUFFER_AGE_EXT, &age);
+    return age;
+#else
+    return 0;
+#endif
+  }
+
+}
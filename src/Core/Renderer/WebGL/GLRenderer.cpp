@@ -9,14 +9,19 @@
  */
 
 #include <neonGX/Core/Renderer/OpenGL/GLRenderer.hpp>
+#include <neonGX/Core/Renderer/OpenGL/RenderThread.hpp>
+#include <neonGX/Core/Sprites/Sprite.hpp>
 #include <neonGX/Core/Sprites/SpriteRenderer.hpp>
+#include <neonGX/Core/Text/Text.hpp>
 #include <neonGX/Core/Text/TextRenderer.hpp>
+#include <neonGX/Core/Textures/RenderTexture.hpp>
 
 #ifdef NEONGX_USE_EMSCRIPTEN
 #include <emscripten/val.h>
 #endif
 
 #include <boost/lexical_cast.hpp>
+#include <chrono>
 
 namespace neonGX {
 
@@ -36,6 +41,7 @@ namespace neonGX {
       gl_settings.majorVersion = 1;
       gl_settings.minorVersion = 0;
       gl_settings.enableExtensionsByDefault = false;
+      gl_settings.preserveDrawingBuffer = EM_BOOL(settings.PartialRedraw);
 
       webgl_handle = emscripten_webgl_create_context(
           target.c_str(), &gl_settings);
@@ -46,6 +52,9 @@ namespace neonGX {
 #endif
     WebGLContextRAII switchCtx(webgl_handle);
 
+    m_StateCache = std::make_unique<GLStateCache>(webgl_handle);
+    m_Extensions = GLExtensions(webgl_handle);
+
     glDisable(GL_DEPTH_TEST);
     glDisable(GL_CULL_FACE);
     glEnable(GL_BLEND);
@@ -54,16 +63,50 @@ namespace neonGX {
 
     m_RenderTarget = std::make_unique<GLRenderTarget>(
         webgl_handle, size, settings.Resolution, ScaleMode::Linear, true);
+    m_CurrentRenderTarget = m_RenderTarget.get();
 
     Resize(size);
 
-    m_FontTextureManager = std::make_shared<FontTextureManager>(webgl_handle);
+#ifdef NEONGX_USE_EMSCRIPTEN
+    m_Settings.UseRenderThread = false;
+#endif
+
+    // Pool slots are written by the GL thread while the game thread assigns
+    // them, sprites are always streamed with a render thread.
+    if(m_Settings.UseRenderThread) {
+      m_Settings.RetainedSprites = false;
+      m_Settings.PartialRedraw = false;
+    }
+
+#ifdef NEONGX_USE_EMSCRIPTEN
+    m_DamageTracker.SetBufferAge(1);
+#endif
+
+    m_FontTextureManager = std::make_shared<FontTextureManager>(
+        webgl_handle, settings.MaxGlyphAtlasPages);
     m_ShaderManager = std::make_unique<ShaderManager>(webgl_handle);
+
+    if(settings.BatchWorkerThreads > 0) {
+      m_BatchWorkers = std::make_unique<WorkerPool>(
+          settings.BatchWorkerThreads);
+    }
+
     m_SpriteRenderer = std::make_unique<SpriteRenderer>(this);
     m_TextRenderer = std::make_unique<TextRenderer>(this);
+
+    if(m_Settings.UseRenderThread) {
+      // Glyphs of the next frame must not evict the pages of the frame
+      // being drawn.
+      m_FontTextureManager->GetGlyphAtlas().SetFramesInFlight(2);
+
+      switchCtx.Restore();
+      m_RenderThread = std::make_unique<RenderThread>(this);
+    }
   }
 
   GLRenderer::~GLRenderer() {
+    m_RenderThread.reset();
+
 #ifndef NEONGX_USE_EMSCRIPTEN
     glfwDestroyWindow(webgl_handle);
 #endif
@@ -72,22 +115,247 @@ namespace neonGX {
   void GLRenderer::Render(DisplayObject* object) {
     assert(object != nullptr);
 
+    if(m_RenderThread) {
+      RenderSnapshot& snapshot = m_RenderThread->GetWriteSnapshot();
+      snapshot.Clear();
+
+      BuildCommandQueue(object, snapshot.Stats);
+      CaptureSnapshot(snapshot);
+
+      m_RenderThread->Publish(m_PresentedStats);
+      return;
+    }
+
     WebGLContextRAII switchCtx(webgl_handle);
 
+    m_Stats = GLRendererStats{};
+    BuildCommandQueue(object, m_Stats);
+
+    if(m_Settings.PartialRedraw) {
+#ifndef NEONGX_USE_EMSCRIPTEN
+      // Swapped back buffers may be any number of frames old, or undefined.
+      m_DamageTracker.SetBufferAge(m_Extensions.GetBufferAge());
+#endif
+      TrackDamage();
+
+      if(m_DamageTracker.GetRects().empty()) {
+        m_Stats.SkippedFrame = true;
+        return;
+      }
+    }
+
+    auto submissionStart = BeginSubmission();
+
+    if(m_Settings.PartialRedraw) {
+      SubmitDamagedRegions();
+    } else {
+      for(const RenderCommand& command : m_CommandQueue.GetCommands()) {
+        SetObjectRenderer(command.Renderer)->Render(command.Object);
+      }
+    }
+
+    EndSubmission(submissionStart);
+  }
+
+  void GLRenderer::TrackDamage() {
+    const auto& commands = m_CommandQueue.GetCommands();
+    m_CommandBounds.resize(commands.size());
+
+    for(size_t i = 0; i < commands.size(); i++) {
+      DisplayObject* object = commands[i].Object;
+      m_CommandBounds[i] = object->GetBounds();
+      m_DamageTracker.Track(object, m_CommandBounds[i],
+          object->GetWorldTransform(), object->GetWorldAlpha(),
+          object->ConsumeRenderChanged());
+    }
+
+    const FSize& size = m_RenderTarget->m_Size.size;
+    m_DamageTracker.EndFrame(NRectangle{
+        {0, 0},
+        {int32_t(std::ceil(size.width)), int32_t(std::ceil(size.height))}
+    });
+
+    m_Stats.DamageRects = m_DamageTracker.GetRects().size();
+  }
+
+  void GLRenderer::SubmitDamagedRegions() {
+    const auto& commands = m_CommandQueue.GetCommands();
+    float resolution = m_RenderTarget->m_Resolution;
+    float height = m_RenderTarget->m_Size.size.height;
+
+    glEnable(GL_SCISSOR_TEST);
+
+    for(NRectangle rect : m_DamageTracker.GetRects()) {
+      // Batches of the previous region are drawn before the scissor moves.
+      if(m_CurrentRenderer) {
+        m_CurrentRenderer->Flush();
+      }
+
+      // Scissor boxes start at the bottom left corner.
+      float bottom = height - float(rect.point.y + rect.size.height);
+      glScissor(GLint(float(rect.point.x) * resolution),
+                GLint(bottom * resolution),
+                GLsizei(float(rect.size.width) * resolution),
+                GLsizei(float(rect.size.height) * resolution));
+
+      if(m_Settings.ClearBeforeRender) {
+        ClearTarget();
+      }
+
+      for(size_t i = 0; i < commands.size(); i++) {
+        if(m_CommandBounds[i].Intersect(rect)) {
+          SetObjectRenderer(commands[i].Renderer)->Render(commands[i].Object);
+        }
+      }
+    }
+
+    if(m_CurrentRenderer) {
+      m_CurrentRenderer->Flush();
+    }
+
+    glDisable(GL_SCISSOR_TEST);
+  }
+
+  void GLRenderer::BuildCommandQueue(DisplayObject* object,
+                                     GLRendererStats& stats) {
+    m_FontTextureManager->GetGlyphAtlas().NextFrame();
+    m_FontTextureManager->ProcessPendingLoads();
+
+    auto traversalStart = std::chrono::steady_clock::now();
+
+    m_CommandQueue.Clear();
+    m_CulledObjects = 0;
+
+    if(m_Settings.CullOffscreen) {
+      m_CullingFrame = FRectangle{ {0, 0}, m_RenderTarget->m_Size.size };
+    }
+
     object->UpdateTransform(true);
+    object->RenderWebGL(this);
+
+    if(m_BatchWorkers) {
+      UpdateSpriteVertices();
+    }
+
+    auto sortStart = std::chrono::steady_clock::now();
+
+    m_CommandQueue.Sort();
+
+    auto sortEnd = std::chrono::steady_clock::now();
+
+    using Milliseconds = std::chrono::duration<float, std::milli>;
+    stats.Commands = m_CommandQueue.GetCommands().size();
+    stats.CulledObjects = m_CulledObjects;
+    stats.TraversalTime = Milliseconds(sortStart - traversalStart).count();
+    stats.SortTime = Milliseconds(sortEnd - sortStart).count();
+  }
+
+  void GLRenderer::CaptureSnapshot(RenderSnapshot& snapshot) {
+    for(const RenderCommand& command : m_CommandQueue.GetCommands()) {
+      switch(command.Renderer) {
+        case ObjectRendererType::Sprite: {
+          auto& sprite = static_cast<Sprite&>(*command.Object);
+
+          snapshot.Commands.push_back(RenderSnapshotCommand{
+              command.Renderer, snapshot.Sprites.size()
+          });
+          snapshot.Sprites.emplace_back();
 
-    if(m_Settings.ClearBeforeRender) {
-      if(m_Settings.Transparent) {
-        glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+          SpriteVertexRecord& record = snapshot.Sprites.back();
+          SpriteRenderer::CaptureRecord(sprite, record);
+
+          if(snapshot.Textures.empty() ||
+             snapshot.Textures.back().get() != record.Texture) {
+            snapshot.Textures.push_back(
+                sprite.GetTexture()->GetBaseTexture());
+          }
+          break;
+        }
+        case ObjectRendererType::Text: {
+          auto& text = static_cast<Text&>(*command.Object);
+
+          TextRenderer::ValidateGlyphs(*m_FontTextureManager, text);
+          TextRun run = TextRenderer::GetTextRun(text);
+
+          snapshot.Commands.push_back(RenderSnapshotCommand{
+              command.Renderer, snapshot.Texts.size()
+          });
+          snapshot.Texts.push_back(RenderSnapshotText{
+              snapshot.Glyphs.size(), run.GlyphCount, run.Mode, run.Color
+          });
+          snapshot.Glyphs.insert(snapshot.Glyphs.end(), run.Glyphs,
+              run.Glyphs + run.GlyphCount);
+          break;
+        }
+        default:
+          assert("Invalid ObjectRenderer type." && false);
+          break;
+      }
+    }
+  }
+
+  void GLRenderer::DrawSnapshot(const RenderSnapshot& snapshot) {
+    WebGLContextRAII switchCtx(webgl_handle);
+
+    m_Stats = snapshot.Stats;
+
+    auto submissionStart = BeginSubmission();
+
+    for(const RenderSnapshotCommand& command : snapshot.Commands) {
+      SetObjectRenderer(command.Renderer);
+
+      if(command.Renderer == ObjectRendererType::Sprite) {
+        m_SpriteRenderer->RenderRecord(snapshot.Sprites[command.Index]);
       } else {
-        ColorRGBA rgba(m_Settings.BackgroundColor);
-        glClearColor(rgba.r, rgba.g, rgba.b, rgba.a);
+        const RenderSnapshotText& text = snapshot.Texts[command.Index];
+        m_TextRenderer->RenderRun(TextRun{
+            snapshot.Glyphs.data() + text.GlyphStart, text.GlyphCount,
+            text.Mode, text.Color
+        });
       }
-      glClear(GL_COLOR_BUFFER_BIT);
     }
 
-    object->RenderWebGL(this);
-    m_CurrentRenderer->Flush();
+    EndSubmission(submissionStart);
+  }
+
+  std::chrono::steady_clock::time_point GLRenderer::BeginSubmission() {
+    auto submissionStart = std::chrono::steady_clock::now();
+
+    m_StateCache->ResetCounters();
+    m_SpriteRenderer->BeginFrame();
+
+    // Partial redraws clear each damaged region on its own.
+    if(m_Settings.ClearBeforeRender && !m_Settings.PartialRedraw) {
+      ClearTarget();
+    }
+
+    return submissionStart;
+  }
+
+  void GLRenderer::ClearTarget() {
+    if(m_Settings.Transparent) {
+      glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+    } else {
+      ColorRGBA rgba(m_Settings.BackgroundColor);
+      glClearColor(rgba.r, rgba.g, rgba.b, rgba.a);
+    }
+    glClear(GL_COLOR_BUFFER_BIT);
+  }
+
+  void GLRenderer::EndSubmission(
+      std::chrono::steady_clock::time_point submissionStart) {
+    if(m_CurrentRenderer) {
+      m_CurrentRenderer->Flush();
+    }
+
+    auto submissionEnd = std::chrono::steady_clock::now();
+
+    using Milliseconds = std::chrono::duration<float, std::milli>;
+    m_Stats.SubmissionTime =
+        Milliseconds(submissionEnd - submissionStart).count();
+
+    m_Stats.StateChanges = m_StateCache->GetIssuedCalls();
+    m_Stats.SkippedStateChanges = m_StateCache->GetSkippedCalls();
   }
 
 #ifdef NEONGX_USE_EMSCRIPTEN
@@ -112,10 +380,120 @@ namespace neonGX {
     glfwSetWindowSize(webgl_handle, int(m_Size.width), int(m_Size.width));
 #endif
 
+    if(m_RenderThread) {
+      m_RenderThread->Finish();
+    }
+
     WebGLContextRAII switchCtx(webgl_handle);
 
     m_RenderTarget->Resize(m_Size);
     m_RenderTarget->Activate();
+
+    m_DamageTracker.Invalidate();
+  }
+
+  bool GLRenderer::CullObject(DisplayObject& object) {
+    if(!m_CullingFrame) {
+      return false;
+    }
+
+    auto bounds = object.GetCachedWorldBounds();
+    if(!bounds) {
+      return false;
+    }
+
+    const FRectangle& frame = m_CullingFrame.value();
+    float x0 = float(bounds->point.x);
+    float y0 = float(bounds->point.y);
+    float x1 = x0 + float(bounds->size.width);
+    float y1 = y0 + float(bounds->size.height);
+
+    bool outside = x1 <= frame.point.x || y1 <= frame.point.y ||
+                   x0 >= frame.point.x + frame.size.width ||
+                   y0 >= frame.point.y + frame.size.height;
+    if(outside) {
+      m_CulledObjects++;
+    }
+    return outside;
+  }
+
+  FRectangle GLRenderer::RenderToTexture(DisplayObject* object,
+                                         RenderTexture& texture,
+                                         optional<FRectangle> region) {
+    assert(object != nullptr);
+    assert(CanRenderToTexture());
+
+    WebGLContextRAII switchCtx(webgl_handle);
+
+    // Called during a traversal the queue of the frame is kept aside.
+    RenderCommandQueue frameQueue;
+    frameQueue.SetSortableLayers(m_CommandQueue.GetSortableLayers());
+    std::swap(frameQueue, m_CommandQueue);
+
+    // Without a region the drawn area is only known after the traversal.
+    optional<FRectangle> frameCullingFrame = m_CullingFrame;
+    m_CullingFrame = m_Settings.CullOffscreen ? region : nullopt;
+    size_t frameCulledObjects = m_CulledObjects;
+
+    object->RenderWebGL(this);
+
+    if(m_BatchWorkers) {
+      UpdateSpriteVertices();
+    }
+
+    m_CommandQueue.Sort();
+
+    if(!region) {
+      NRectangle bounds = object->GetBounds();
+      region = FRectangle{
+          {float(bounds.point.x), float(bounds.point.y)},
+          {float(bounds.size.width), float(bounds.size.height)}
+      };
+    }
+
+    if(region->size.width > 0.0f && region->size.height > 0.0f) {
+      texture.Resize(region->size);
+
+      GLRenderTarget& target = texture.GetRenderTarget();
+      target.m_TransformMatrix = Affine2D::Translation(
+          -region->point.x, -region->point.y);
+      target.Activate();
+      target.Clear();
+
+      m_CurrentRenderTarget = &target;
+
+      for(const RenderCommand& command : m_CommandQueue.GetCommands()) {
+        SetObjectRenderer(command.Renderer)->Render(command.Object);
+      }
+
+      if(m_CurrentRenderer) {
+        m_CurrentRenderer->Flush();
+      }
+
+      m_CurrentRenderTarget = m_RenderTarget.get();
+      m_RenderTarget->Activate();
+    }
+
+    std::swap(frameQueue, m_CommandQueue);
+    m_CullingFrame = frameCullingFrame;
+    m_CulledObjects = frameCulledObjects;
+
+    return region.value();
+  }
+
+  void GLRenderer::UpdateSpriteVertices() {
+    // Every sprite is queued at most once per frame, so the jobs never
+    // touch the same sprite.
+    const auto& commands = m_CommandQueue.GetCommands();
+
+    m_BatchWorkers->ParallelFor(commands.size(), SpriteVertexGrain,
+        [&commands](size_t begin, size_t end) {
+      for(size_t i = begin; i < end; i++) {
+        if(commands[i].Renderer == ObjectRendererType::Sprite) {
+          static_cast<Sprite*>(commands[i].Object)->UpdateVertices();
+        }
+      }
+    });
   }
 
   ObjectRenderer* GLRenderer::SetObjectRenderer(ObjectRendererType type) {
@@ -0,0 +1,192 @@
+/*
+ * neonGX - GLStateCache.cpp
+ *
+ * Copyright (c) 2016, cynecx
+ *
+ * This file is part of neonGX and is distributed under a modified
+ * BSD 3-Clause License. See LICENSE.txt for details.
+ *
+ */
+
+#include <neonGX/Core/Renderer/OpenGL/GLStateCache.hpp>
+#include <algorithm>
+#include <cassert>
+
+namespace neonGX {
+
+  // There is rarely more than a single context, a linear scan is plenty.
+  static std::vector<GLStateCache*>& GetStateCacheRegistry() {
+    static std::vector<GLStateCache*> registry;
+    return registry;
+  }
+
+  GLStateCache::GLStateCache(webgl_context_handle glHandle)
+      : m_GLHandle(glHandle) {
+    assert(ForContext(glHandle) == nullptr);
+
+    WebGLContextRAII switchCtx(m_GLHandle);
+
+    GLint maxTextureUnits = 0;
+    glGetIntegerv(GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS, &maxTextureUnits);
+    m_Textures.resize(size_t(std::max<GLint>(maxTextureUnits, 1)));
+
+    Invalidate();
+
+    GetStateCacheRegistry().push_back(this);
+  }
+
+  GLStateCache::~GLStateCache() {
+    auto& registry = GetStateCacheRegistry();
+
+    auto it = std::find(registry.begin(), registry.end(), this);
+    assert(it != registry.end());
+
+    registry.erase(it);
+  }
+
+  GLStateCache* GLStateCache::ForContext(webgl_context_handle glHandle) {
+    for(GLStateCache* cache : GetStateCacheRegistry()) {
+      if(cache->m_GLHandle == glHandle) {
+        return cache;
+      }
+    }
+
+    return nullptr;
+  }
+
+  void GLStateCache::Invalidate() {
+    m_Program = UnknownObject;
+    m_ArrayBuffer = UnknownObject;
+    m_ElementBuffer = UnknownObject;
+    m_ActiveUnit = std::numeric_limits<size_t>::max();
+    std::fill(m_Textures.begin(), m_Textures.end(), UnknownObject);
+    m_BlendSrc = UnknownEnum;
+    m_BlendDst = UnknownEnum;
+    m_Viewport.fill(UnknownInt);
+  }
+
+  void GLStateCache::UseProgram(GLuint program) {
+    if(m_Program == program) {
+      m_SkippedCalls++;
+      return;
+    }
+
+    WebGLContextRAII switchCtx(m_GLHandle);
+    glUseProgram(program);
+
+    m_Program = program;
+    m_IssuedCalls++;
+  }
+
+  void GLStateCache::BindBuffer(GLenum target, GLuint buffer) {
+    GLuint* bound = nullptr;
+
+    switch(target) {
+      case GL_ARRAY_BUFFER:
+        bound = &m_ArrayBuffer;
+        break;
+      case GL_ELEMENT_ARRAY_BUFFER:
+        bound = &m_ElementBuffer;
+        break;
+      default:
+        assert("Invalid buffer target." && false);
+        break;
+    }
+
+    if(*bound == buffer) {
+      m_SkippedCalls++;
+      return;
+    }
+
+    WebGLContextRAII switchCtx(m_GLHandle);
+    glBindBuffer(target, buffer);
+
+    *bound = buffer;
+    m_IssuedCalls++;
+  }
+
+  void GLStateCache::ActiveTexture(size_t unit) {
+    assert(unit < m_Textures.size());
+
+    if(m_ActiveUnit == unit) {
+      m_SkippedCalls++;
+      return;
+    }
+
+    WebGLContextRAII switchCtx(m_GLHandle);
+    glActiveTexture(GLenum(GL_TEXTURE0 + unit));
+
+    m_ActiveUnit = unit;
+    m_IssuedCalls++;
+  }
+
+  void GLStateCache::BindTexture(optional<size_t> unit, GLuint texture) {
+    if(unit) {
+      ActiveTexture(*unit);
+    }
+
+    // The active unit is unknown, so is what's bound to it.
+    if(m_ActiveUnit >= m_Textures.size()) {
+      WebGLContextRAII switchCtx(m_GLHandle);
+      glBindTexture(GL_TEXTURE_2D, texture);
+
+      m_IssuedCalls++;
+      return;
+    }
+
+    if(m_Textures[m_ActiveUnit] == texture) {
+      m_SkippedCalls++;
+      return;
+    }
+
+    WebGLContextRAII switchCtx(m_GLHandle);
+    glBindTexture(GL_TEXTURE_2D, texture);
+
+    m_Textures[m_ActiveUnit] = texture;
+    m_IssuedCalls++;
+  }
+
+  void GLStateCache::BlendFunc(GLenum src, GLenum dst) {
+    if(m_BlendSrc == src && m_BlendDst == dst) {
+      m_SkippedCalls++;
+      return;
+    }
+
+    WebGLContextRAII switchCtx(m_GLHandle);
+    glBlendFunc(src, dst);
+
+    m_BlendSrc = src;
+    m_BlendDst = dst;
+    m_IssuedCalls++;
+  }
+
+  void GLStateCache::Viewport(GLint x, GLint y, GLint width, GLint height) {
+    std::array<GLint, 4> viewport{{x, y, width, height}};
+
+    if(m_Viewport == viewport) {
+      m_SkippedCalls++;
+      return;
+    }
+
+    WebGLContextRAII switchCtx(m_GLHandle);
+    glViewport(x, y, width, height);
+
+    m_Viewport = viewport;
+    m_IssuedCalls++;
+  }
+
+  void GLStateCache::OnDeleteBuffer(GLuint buffer) {
+    if(m_ArrayBuffer == buffer) {
+      m_ArrayBuffer = 0;
+    }
+
+    if(m_ElementBuffer == buffer) {
+      m_ElementBuffer = 0;
+    }
+  }
+
+  void GLStateCache::OnDeleteTexture(GLuint texture) {
+    std::replace(m_Textures.begin(), m_Textures.end(), texture, GLuint(0));
+  }
+
+}
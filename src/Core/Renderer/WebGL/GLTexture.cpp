@@ -9,6 +9,7 @@
  */
 
 #include <neonGX/Core/Renderer/OpenGL/GLTexture.hpp>
+#include <neonGX/Core/Renderer/OpenGL/GLStateCache.hpp>
 
 namespace neonGX {
 
@@ -32,6 +33,10 @@ namespace neonGX {
       return;
     }
 
+    if(auto* stateCache = GLStateCache::ForContext(m_GLHandle)) {
+      stateCache->OnDeleteTexture(m_Texture);
+    }
+
     WebGLContextRAII switchCtx(m_GLHandle);
 
     GLuint tmpTexArr[1] = { m_Texture };
@@ -39,6 +44,12 @@ namespace neonGX {
   }
 
   void GLTexture::Bind(optional<GLenum> location) const {
+    if(auto* stateCache = GLStateCache::ForContext(m_GLHandle)) {
+      stateCache->BindTexture(location ? optional<size_t>(*location) : nullopt,
+          m_Texture);
+      return;
+    }
+
     WebGLContextRAII switchCtx(m_GLHandle);
 
     if(location) {
@@ -49,8 +60,13 @@ namespace neonGX {
   }
 
   void GLTexture::Unbind() {
+    if(auto* stateCache = GLStateCache::ForContext(m_GLHandle)) {
+      stateCache->BindTexture(nullopt, 0);
+      return;
+    }
+
     WebGLContextRAII switchCtx(m_GLHandle);
-    glBindFramebuffer(GL_TEXTURE_2D, 0);
+    glBindTexture(GL_TEXTURE_2D, 0);
   }
 
   void GLTexture::UploadImage(const PNGImage& image) {
@@ -104,6 +120,30 @@ namespace neonGX {
         data.data());
   }
 
+  void GLTexture::UploadSubData(gsl::span<const uint8_t> data,
+                                const NRectangle& region) {
+    Bind(nullopt);
+
+    assert(region.point.x >= 0 && region.point.y >= 0);
+    assert(region.point.x + region.size.width <= int32_t(m_Size.width));
+    assert(region.point.y + region.size.height <= int32_t(m_Size.height));
+
+    WebGLContextRAII switchCtx(m_GLHandle);
+
+#ifdef NEONGX_USE_EMSCRIPTEN
+    glPixelStorei(GL_UNPACK_PREMULTIPLY_ALPHA_WEBGL, GL_TRUE);
+#endif
+    glTexSubImage2D(GL_TEXTURE_2D,
+        0,
+        region.point.x,
+        region.point.y,
+        region.size.width,
+        region.size.height,
+        m_Format,
+        m_Type,
+        data.data());
+  }
+
   FSize GLTexture::GetSize() const {
     return m_Size;
   }
@@ -0,0 +1,76 @@
+/*
+ * neonGX - RenderCommandQueue.cpp
+ *
+ * Copyright (c) 2016, cynecx
+ *
+ * This file is part of neonGX and is distributed under a modified
+ * BSD 3-Clause License. See LICENSE.txt for details.
+ *
+ */
+
+#include <neonGX/Core/Renderer/OpenGL/RenderCommandQueue.hpp>
+#include <array>
+#include <cassert>
+
+namespace neonGX {
+
+  void RenderCommandQueue::Push(uint8_t layer, ObjectRendererType renderer,
+                                uint8_t shader, uint32_t texture,
+                                DisplayObject* object) {
+    assert(m_Sequence <= SequenceMask && "Too many render commands.");
+
+    uint64_t key = uint64_t(layer) << LayerShift;
+
+    if(m_SortableLayers.test(layer)) {
+      key |= (uint64_t(renderer) & RendererMask) << RendererShift;
+      key |= (uint64_t(shader) & ShaderMask) << ShaderShift;
+      key |= (uint64_t(texture) & TextureMask) << TextureShift;
+    }
+
+    key |= uint64_t(m_Sequence++) & SequenceMask;
+
+    m_Commands.push_back(RenderCommand{key, object, renderer});
+  }
+
+  void RenderCommandQueue::Sort() {
+    size_t count = m_Commands.size();
+
+    // A single layer without sortable layers is already in order.
+    bool sorted = true;
+    for(size_t i = 1; i < count && sorted; i++) {
+      sorted = m_Commands[i - 1].SortKey <= m_Commands[i].SortKey;
+    }
+
+    if(sorted) {
+      return;
+    }
+
+    m_Scratch.resize(count);
+
+    for(unsigned shift = 0; shift < 64; shift += 8) {
+      std::array<size_t, 256> offsets{};
+
+      for(const RenderCommand& command : m_Commands) {
+        offsets[(command.SortKey >> shift) & 0xFF]++;
+      }
+
+      if(offsets[(m_Commands.front().SortKey >> shift) & 0xFF] == count) {
+        continue;
+      }
+
+      size_t offset = 0;
+      for(size_t& bucket : offsets) {
+        size_t size = bucket;
+        bucket = offset;
+        offset += size;
+      }
+
+      for(const RenderCommand& command : m_Commands) {
+        m_Scratch[offsets[(command.SortKey >> shift) & 0xFF]++] = command;
+      }
+
+      m_Commands.swap(m_Scratch);
+    }
+  }
+
+}
@@ -0,0 +1,91 @@
+/*
+ * neonGX - RenderThread.cpp
+ *
+ * Copyright (c) 2016, cynecx
+ *
+ * This file is part of neonGX and is distributed under a modified
+ * BSD 3-Clause License. See LICENSE.txt for details.
+ *
+ */
+
+#include <neonGX/Core/Renderer/OpenGL/RenderThread.hpp>
+#include <cassert>
+
+namespace neonGX {
+
+  RenderThread::RenderThread(GLRenderer* renderer) : m_Renderer(renderer) {
+#ifdef NEONGX_USE_EMSCRIPTEN
+    assert("Render threads are not supported by emscripten builds." && false);
+#else
+    m_Thread = std::thread(&RenderThread::ThreadLoop, this);
+#endif
+  }
+
+  RenderThread::~RenderThread() {
+    {
+      std::lock_guard<std::mutex> lock(m_Mutex);
+      m_Stopping = true;
+    }
+    m_Published.notify_one();
+
+    if(m_Thread.joinable()) {
+      m_Thread.join();
+    }
+  }
+
+  void RenderThread::Publish(GLRendererStats& lastFrameStats) {
+    {
+      std::unique_lock<std::mutex> lock(m_Mutex);
+      m_Drawn.wait(lock, [this] { return !m_Pending && !m_Drawing; });
+
+      // The render thread is idle, its stats are complete.
+      lastFrameStats = m_Renderer->m_Stats;
+
+      m_WriteIndex ^= 1;
+      m_Pending = true;
+    }
+    m_Published.notify_one();
+  }
+
+  void RenderThread::Finish() {
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    m_Drawn.wait(lock, [this] { return !m_Pending && !m_Drawing; });
+  }
+
+  void RenderThread::ThreadLoop() {
+    for(;;) {
+      size_t readIndex;
+
+      {
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        m_Published.wait(lock, [this] { return m_Stopping || m_Pending; });
+
+        // Pending snapshots are still drawn, Finish never waits forever.
+        if(!m_Pending) {
+          return;
+        }
+
+        m_Pending = false;
+        m_Drawing = true;
+        readIndex = m_WriteIndex ^ 1;
+      }
+
+      // The context is only current while drawing, Finish hands it back to
+      // the game thread.
+      {
+        WebGLContextRAII switchCtx(m_Renderer->webgl_handle);
+        m_Renderer->DrawSnapshot(m_Snapshots[readIndex]);
+#ifndef NEONGX_USE_EMSCRIPTEN
+        glfwSwapBuffers(m_Renderer->webgl_handle);
+#endif
+      }
+
+      {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Drawing = false;
+      }
+      m_Drawn.notify_all();
+    }
+  }
+
+}
@@ -57,29 +57,32 @@ namespace neonGX {
         m_ShaderManager(shaderManager) {
   }
 
+  FontTextureShader::FontTextureShader(webgl_context_handle glHandle,
+                                       ShaderManager* shaderManager,
+                                       const std::string& fragmentSrc)
+      : GLShader(glHandle, VertexShaderSource, fragmentSrc),
+        m_ShaderManager(shaderManager) {
+  }
+
   FontTextureShader::~FontTextureShader() = default;
 
-  void FontTextureShader::SetProjectionMatrix(const Matrix3& mat) {
+  void FontTextureShader::Activate() {
     if(m_ShaderManager) {
       m_ShaderManager->UseFontTextureShader();
     } else {
       GLShader::Bind();
     }
+  }
 
-    WebGLContextRAII switchCtx(m_GLHandle);
+  void FontTextureShader::SetProjectionMatrix(const Affine2D& mat) {
+    Activate();
 
-    const auto col0 = mat.GetColumnAccessor(0);
-    const auto col1 = mat.GetColumnAccessor(1);
-    const auto col2 = mat.GetColumnAccessor(2);
+    WebGLContextRAII switchCtx(m_GLHandle);
 
-    float matTemp[] {
-        col0[0], col0[1], col0[2],
-        col1[0], col1[1], col1[2],
-        col2[0], col2[1], col2[2]
-    };
+    auto matTemp = mat.ToColumnMajor();
 
     GLint location = m_uniformLocations["projectionMatrix"].Location;
-    glUniformMatrix3fv(location, 1, GL_FALSE, matTemp);
+    glUniformMatrix3fv(location, 1, GL_FALSE, matTemp.data());
   }
 
 }
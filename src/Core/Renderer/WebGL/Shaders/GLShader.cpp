@@ -9,6 +9,7 @@
  */
 
 #include <neonGX/Core/Renderer/OpenGL/Shaders/GLShader.hpp>
+#include <neonGX/Core/Renderer/OpenGL/GLStateCache.hpp>
 
 namespace neonGX {
 
@@ -26,6 +27,15 @@ namespace neonGX {
 
     assert(m_Program != 0);
 
+    UseProgram();
+  }
+
+  void GLShader::UseProgram() {
+    if(auto* stateCache = GLStateCache::ForContext(m_GLHandle)) {
+      stateCache->UseProgram(m_Program);
+      return;
+    }
+
     WebGLContextRAII switchCtx(m_GLHandle);
     glUseProgram(m_Program);
   }
@@ -76,9 +86,9 @@ namespace neonGX {
 
   void GLShader::InitializeShaders() {
     CompileShaders();
+    UseProgram();
 
     WebGLContextRAII switchCtx(m_GLHandle);
-    glUseProgram(m_Program);
 
     GLint activeAttributes = 0;
     glGetProgramiv(m_Program, GL_ACTIVE_ATTRIBUTES, &activeAttributes);
@@ -0,0 +1,64 @@
+/*
+ * neonGX - InstancedTextureShader.cpp
+ *
+ * Copyright (c) 2016, cynecx
+ *
+ * This file is part of neonGX and is distributed under a modified
+ * BSD 3-Clause License. See LICENSE.txt for details.
+ *
+ */
+
+#include <neonGX/Core/Renderer/OpenGL/Shaders/InstancedTextureShader.hpp>
+#include <neonGX/Core/Renderer/OpenGL/Managers/ShaderManager.hpp>
+
+namespace neonGX {
+
+  static constexpr auto VertexShaderSource =
+      R"SOURCE(
+          #version 100
+
+          precision highp float;
+
+          attribute vec2 aQuadCorner;
+
+          attribute vec2 aTranslation;
+          attribute vec4 aTransform;
+          attribute vec4 aFrame;
+          attribute vec4 aColor;
+          attribute float aTextureId;
+
+          uniform mat3 projectionMatrix;
+
+          varying vec2 vTextureCoord;
+          varying vec4 vColor;
+          varying float vTextureId;
+
+          void main(void){
+             vec2 position = aTranslation +
+                 aTransform.xy * aQuadCorner.x + aTransform.zw * aQuadCorner.y;
+
+             gl_Position = vec4((projectionMatrix * vec3(position, 1.0)).xy, 0.0, 1.0);
+             vTextureCoord = mix(aFrame.xy, aFrame.zw, aQuadCorner);
+             vColor = vec4(aColor.rgb * aColor.a, aColor.a);
+             vTextureId = aTextureId;
+          }
+        )SOURCE";
+
+  InstancedTextureShader::InstancedTextureShader(
+      webgl_context_handle glHandle, ShaderManager* shaderManager,
+      size_t textureCount)
+      : TextureShader(glHandle, shaderManager, textureCount,
+                      VertexShaderSource) {
+  }
+
+  InstancedTextureShader::~InstancedTextureShader() = default;
+
+  void InstancedTextureShader::Activate() {
+    if(m_ShaderManager) {
+      m_ShaderManager->UseInstancedTextureShader();
+    } else {
+      GLShader::Bind();
+    }
+  }
+
+}
@@ -0,0 +1,73 @@
+/*
+ * neonGX - SDFFontTextureShader.cpp
+ *
+ * Copyright (c) 2016, cynecx
+ *
+ * This file is part of neonGX and is distributed under a modified
+ * BSD 3-Clause License. See LICENSE.txt for details.
+ *
+ */
+
+#include <neonGX/Core/Renderer/OpenGL/Shaders/SDFFontTextureShader.hpp>
+#include <neonGX/Core/Renderer/OpenGL/Managers/ShaderManager.hpp>
+
+namespace neonGX {
+
+  static constexpr auto FragmentShaderSource =
+      R"SOURCE(
+          #version 100
+          #extension GL_OES_standard_derivatives : enable
+
+          precision highp float;
+
+          varying vec2 vTextureCoord;
+          varying vec3 vColor;
+
+          uniform sampler2D uSampler;
+
+          void main() {
+            float distance = texture2D(uSampler, vTextureCoord).r;
+            float width = 0.7 * fwidth(distance);
+            float alpha = smoothstep(0.5 - width, 0.5 + width, distance);
+            gl_FragColor = vec4(vColor * alpha, alpha);
+          }
+        )SOURCE";
+
+  static constexpr auto FixedWidthFragmentShaderSource =
+      R"SOURCE(
+          #version 100
+
+          precision highp float;
+
+          varying vec2 vTextureCoord;
+          varying vec3 vColor;
+
+          uniform sampler2D uSampler;
+
+          void main() {
+            float distance = texture2D(uSampler, vTextureCoord).r;
+            float alpha = smoothstep(0.44, 0.56, distance);
+            gl_FragColor = vec4(vColor * alpha, alpha);
+          }
+        )SOURCE";
+
+  SDFFontTextureShader::SDFFontTextureShader(webgl_context_handle glHandle,
+                                             ShaderManager* shaderManager,
+                                             bool standardDerivatives)
+      : FontTextureShader(glHandle, shaderManager,
+                          standardDerivatives ?
+                              FragmentShaderSource :
+                              FixedWidthFragmentShaderSource) {
+  }
+
+  SDFFontTextureShader::~SDFFontTextureShader() = default;
+
+  void SDFFontTextureShader::Activate() {
+    if(m_ShaderManager) {
+      m_ShaderManager->UseSDFFontTextureShader();
+    } else {
+      GLShader::Bind();
+    }
+  }
+
+}
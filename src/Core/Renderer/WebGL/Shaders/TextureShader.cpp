@@ -10,6 +10,9 @@
 
 #include <neonGX/Core/Renderer/OpenGL/Shaders/TextureShader.hpp>
 #include <neonGX/Core/Renderer/OpenGL/Managers/ShaderManager.hpp>
+#include <numeric>
+#include <string>
+#include <vector>
 
 namespace neonGX {
 
@@ -22,82 +25,121 @@ namespace neonGX {
           attribute vec2 aVertexPosition;
           attribute vec2 aTextureCoord;
           attribute vec4 aColor;
+          attribute float aTextureId;
 
           uniform mat3 projectionMatrix;
 
           varying vec2 vTextureCoord;
           varying vec4 vColor;
+          varying float vTextureId;
 
           void main(void){
              gl_Position = vec4((projectionMatrix * vec3(aVertexPosition, 1.0)).xy, 0.0, 1.0);
              vTextureCoord = aTextureCoord;
              vColor = vec4(aColor.rgb * aColor.a, aColor.a);
+             vTextureId = aTextureId;
           }
         )SOURCE";
 
-  static constexpr auto FragmentShaderSource =
-      R"SOURCE(
+  // GLSL ES 1.00 only allows constant indices into sampler arrays, so the
+  // sampler is picked through an unrolled if-chain.
+  static std::string GenerateFragmentShaderSource(size_t textureCount) {
+    assert(textureCount > 0);
+
+    std::string samplerSelection;
+    for(size_t i = 0; i < textureCount; i++) {
+      auto index = std::to_string(i);
+
+      if(i > 0) {
+        samplerSelection += " else ";
+      }
+
+      if(i + 1 < textureCount) {
+        samplerSelection += "if(textureId < " + index + ".5) ";
+      }
+
+      samplerSelection +=
+          "{\n              color = texture2D(uSamplers[" + index +
+          "], vTextureCoord);\n            }";
+    }
+
+    return R"SOURCE(
           #version 100
 
           precision highp float;
 
           varying vec2 vTextureCoord;
           varying vec4 vColor;
+          varying float vTextureId;
 
-          uniform sampler2D uSampler;
+          uniform sampler2D uSamplers[)SOURCE" +
+        std::to_string(textureCount) + R"SOURCE(];
 
           void main() {
-            gl_FragColor = texture2D(uSampler, vTextureCoord) * vColor;
+            float textureId = vTextureId;
+            vec4 color;
+
+            )SOURCE" + samplerSelection + R"SOURCE(
+
+            gl_FragColor = color * vColor;
           }
         )SOURCE";
+  }
+
+  TextureShader::TextureShader(webgl_context_handle glHandle,
+                               ShaderManager* shaderManager,
+                               size_t textureCount)
+      : TextureShader(glHandle, shaderManager, textureCount,
+                      VertexShaderSource) {
+  }
 
   TextureShader::TextureShader(webgl_context_handle glHandle,
-                               ShaderManager* shaderManager)
-      : GLShader(glHandle, VertexShaderSource, FragmentShaderSource),
+                               ShaderManager* shaderManager,
+                               size_t textureCount,
+                               const std::string& vertexSrc)
+      : GLShader(glHandle, vertexSrc,
+                 GenerateFragmentShaderSource(textureCount)),
+        m_TextureCount(GLint(textureCount)),
         m_ShaderManager(shaderManager) {
   }
 
   TextureShader::~TextureShader() = default;
 
-  void TextureShader::SetProjectionMatrix(const Matrix3& mat) {
+  void TextureShader::Activate() {
     if(m_ShaderManager) {
       m_ShaderManager->UseTextureShader();
     } else {
       GLShader::Bind();
     }
+  }
 
-    WebGLContextRAII switchCtx(m_GLHandle);
+  void TextureShader::SetProjectionMatrix(const Affine2D& mat) {
+    Activate();
 
-    const auto col0 = mat.GetColumnAccessor(0);
-    const auto col1 = mat.GetColumnAccessor(1);
-    const auto col2 = mat.GetColumnAccessor(2);
+    WebGLContextRAII switchCtx(m_GLHandle);
 
-    float matTemp[] {
-        col0[0], col0[1], col0[2],
-        col1[0], col1[1], col1[2],
-        col2[0], col2[1], col2[2]
-    };
+    auto matTemp = mat.ToColumnMajor();
 
     GLint location = m_uniformLocations["projectionMatrix"].Location;
-    glUniformMatrix3fv(location, 1, GL_FALSE, matTemp);
+    glUniformMatrix3fv(location, 1, GL_FALSE, matTemp.data());
   }
 
-  void TextureShader::SetSampler2D(BaseTexture& data) {
-    if(m_ShaderManager) {
-      m_ShaderManager->UseTextureShader();
-    } else {
-      GLShader::Bind();
-    }
+  void TextureShader::SetSamplerUnits() {
+    Activate();
 
     WebGLContextRAII switchCtx(m_GLHandle);
 
-    glActiveTexture(GLenum(GL_TEXTURE0 + m_TextureCount));
-    data.GetGLTexture(m_GLHandle)->Bind(nullopt);
+    // Sampler i always reads from texture unit i.
+    std::vector<GLint> units(static_cast<size_t>(m_TextureCount));
+    std::iota(units.begin(), units.end(), 0);
 
-    GLint location = m_uniformLocations["uSampler"].Location;
-    glUniform1i(location, m_TextureCount);
+    auto it = m_uniformLocations.find("uSamplers[0]");
+    if(it == m_uniformLocations.end()) {
+      it = m_uniformLocations.find("uSamplers");
+    }
+    assert(it != m_uniformLocations.end());
 
-    m_TextureCount++;
+    glUniform1iv(it->second.Location, m_TextureCount, units.data());
   }
 
 }
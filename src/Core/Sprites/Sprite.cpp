@@ -10,6 +10,7 @@
 
 #include <neonGX/Core/Sprites/Sprite.hpp>
 #include <neonGX/Core/Sprites/SpriteRenderer.hpp>
+#include <algorithm>
 
 namespace neonGX {
 
@@ -18,15 +19,30 @@ namespace neonGX {
     SetTexture(texture);
   }
 
-  Sprite::~Sprite() = default;
+  Sprite::~Sprite() {
+    auto vertexPool = m_VertexPool.lock();
+    if(vertexPool && m_VertexSlot != SpriteVertexPool::InvalidSlot) {
+      vertexPool->Free(m_VertexSlot);
+    }
+  }
 
   void Sprite::RenderWebGL(GLRenderer *renderer) {
-    if(m_TextureDirty) {
-      m_TextureDirty = false;
-      CalculateVertices();
+    // With batch workers the vertices of all queued sprites are computed
+    // in parallel once the traversal is done.
+    if(!renderer->GetBatchWorkers()) {
+      UpdateVertices();
+
+      if(renderer->CullObject(*this)) {
+        return;
+      }
     }
 
-    renderer->SetObjectRenderer(ObjectRendererType::Sprite)->Render(this);
+    // Heap pointers are at least 16 byte aligned, the low bits carry no
+    // information for grouping by texture.
+    auto texture = reinterpret_cast<uintptr_t>(
+        m_Texture->GetBaseTexture().get()) >> 4;
+    renderer->SubmitRenderCommand(ObjectRendererType::Sprite, this, 0,
+        static_cast<uint32_t>(texture));
   }
 
   void Sprite::SetTexture(const std::shared_ptr<Texture>& texture) {
@@ -36,6 +52,7 @@ namespace neonGX {
 
     m_Texture = texture;
     m_TextureDirty = true;
+    m_VertexSlotDirty = true;
 
     if(m_CurrSize.width) {
       m_Scale.x = ExtractSign(m_Scale.x) *
@@ -46,9 +63,61 @@ namespace neonGX {
       m_Scale.y = ExtractSign(m_Scale.y) *
                   m_CurrSize.height / m_Texture->GetSize().height;
     }
+
+    // The scale follows the texture while a size is set.
+    if(m_CurrSize.width || m_CurrSize.height) {
+      TransformChanged();
+    } else {
+      ContentChanged();
+    }
+  }
+
+  NRectangle Sprite::GetBounds() {
+    UpdateVertices();
+    return m_WorldBounds;
+  }
+
+  bool Sprite::HitTestLocal(const FPoint& point) {
+    FRectangle frame = m_Texture->GetFrame();
+
+    // Position within the frame, the quad is centered around the anchor.
+    float x = point.x + frame.size.width * m_Anchor.x;
+    float y = point.y + frame.size.height * m_Anchor.y;
+
+    if(x < 0.0f || y < 0.0f ||
+       x >= frame.size.width || y >= frame.size.height) {
+      return false;
+    }
+
+    if(!m_HitAlphaThreshold) {
+      return true;
+    }
+
+    const auto& baseTexture = m_Texture->GetBaseTexture();
+    const PNGImage* image = baseTexture->m_Image.get();
+    if(!image || image->RawData.empty() ||
+       baseTexture->m_Size.width <= 0.0f ||
+       baseTexture->m_Size.height <= 0.0f) {
+      return true;
+    }
+
+    // Frames are given in the size of the base texture, not in pixels.
+    float scaleX = float(image->Width) / baseTexture->m_Size.width;
+    float scaleY = float(image->Height) / baseTexture->m_Size.height;
+
+    size_t pixelX = std::min(size_t((frame.point.x + x) * scaleX),
+                             image->Width - 1);
+    size_t pixelY = std::min(size_t((frame.point.y + y) * scaleY),
+                             image->Height - 1);
+
+    // RGBA, see PNGImage::FormatType.
+    uint8_t alpha = image->RawData[(pixelY * image->Width + pixelX) * 4 + 3];
+    return alpha >= m_HitAlphaThreshold;
   }
 
   void Sprite::CalculateVertices() {
+    m_VertexSlotDirty = true;
+
     FRectangle orig = m_Texture->GetFrame();
 
     float w0 = (orig.size.width) * (1 - m_Anchor.x);
@@ -57,25 +126,28 @@ namespace neonGX {
     float h0 = orig.size.height * (1 - m_Anchor.y);
     float h1 = orig.size.height * -m_Anchor.y;
 
-    auto result = m_WorldTransform * Matrix<3, 1, float>{w1, h1, 1.0f};
-    auto accessor = result.GetColumnAccessor(0);
-    m_VertexData[0] = accessor[0];
-    m_VertexData[1] = accessor[1];
-
-    result = m_WorldTransform * Matrix<3, 1, float>{w0, h1, 1.0f};
-    auto accessor2 = result.GetColumnAccessor(0);
-    m_VertexData[2] = accessor2[0];
-    m_VertexData[3] = accessor2[1];
-
-    result = m_WorldTransform * Matrix<3, 1, float>{w0, h0, 1.0f};
-    auto accessor3 = result.GetColumnAccessor(0);
-    m_VertexData[4] = accessor3[0];
-    m_VertexData[5] = accessor3[1];
-
-    result = m_WorldTransform * Matrix<3, 1, float>{w1, h0, 1.0f};
-    auto accessor4 = result.GetColumnAccessor(0);
-    m_VertexData[6] = accessor4[0];
-    m_VertexData[7] = accessor4[1];
+    const float corners[8] = {
+        w1, h1,
+        w0, h1,
+        w0, h0,
+        w1, h0
+    };
+    m_WorldTransform.Apply(corners, m_VertexData.data(), 4);
+
+    float minX = m_VertexData[0];
+    float minY = m_VertexData[1];
+    float maxX = minX;
+    float maxY = minY;
+
+    for(size_t i = 2; i < m_VertexData.size(); i += 2) {
+      minX = std::min(minX, m_VertexData[i]);
+      maxX = std::max(maxX, m_VertexData[i]);
+      minY = std::min(minY, m_VertexData[i + 1]);
+      maxY = std::max(maxY, m_VertexData[i + 1]);
+    }
+
+    m_WorldBounds = RoundOutBounds(minX, minY, maxX, maxY);
+    m_WorldBoundsValid = true;
   }
 
 }
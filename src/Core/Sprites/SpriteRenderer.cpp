@@ -10,6 +10,7 @@
 
 #include <neonGX/Core/Sprites/SpriteRenderer.hpp>
 #include <neonGX/Core/Sprites/Sprite.hpp>
+#include <limits>
 
 namespace neonGX {
 
@@ -18,25 +19,84 @@ namespace neonGX {
 
     WebGLContextRAII switchCtx(m_GLHandle);
 
-    m_Vertices.resize(BatchSize * 4 * VertexByteSize);
+    m_CompactVertices = m_Renderer->m_Settings.BatchVertexFormat ==
+        VertexFormat::Compact;
+    if(m_CompactVertices) {
+      m_VertexByteSize = CompactVertexByteSize;
+      m_InstanceByteSize = CompactInstanceByteSize;
+    }
+
+    m_Vertices.resize(BatchSize * 4 * m_VertexByteSize);
+    m_Records.reserve(BatchSize);
+
+    m_ReorderBatches = m_Renderer->m_Settings.ReorderSpriteBatches;
+    if(m_ReorderBatches) {
+      m_RecordGroups.reserve(BatchSize);
+      m_SortedRecords.reserve(BatchSize);
+    }
+
+    auto& shaderManager = m_Renderer->m_ShaderManager;
+    m_MaxBatchTextures = std::max<size_t>(1, std::min({
+        m_Renderer->m_Settings.MaxBatchTextures,
+        shaderManager->GetMaxTextureUnits(),
+        MaxBatchTextures
+    }));
 
-    m_Renderer->m_ShaderManager->InitializeTextureShader();
+    // Retained sprites take precedence since their vertices are already
+    // resident on the GPU.
+    m_Instanced = m_Renderer->m_Settings.InstancedSprites &&
+        !m_Renderer->m_Settings.RetainedSprites &&
+        m_Renderer->m_Extensions.HasInstancedArrays();
 
     CreateIndicesForQuads();
 
+    if(m_Instanced) {
+      shaderManager->InitializeInstancedTextureShader(m_MaxBatchTextures);
+      shaderManager->UseInstancedTextureShader().SetSamplerUnits();
+
+      static const float quadCorners[] = {
+          0.0f, 0.0f, 1.0f, 0.0f, 1.0f, 1.0f, 0.0f, 1.0f
+      };
+
+      gsl::span<const uint8_t> corners(
+          reinterpret_cast<const uint8_t*>(quadCorners), sizeof(quadCorners));
+      gsl::span<const uint8_t> quadIndices(
+          reinterpret_cast<const uint8_t*>(m_Indices.data()),
+          6 * sizeof(uint16_t));
+
+      m_QuadVertexBuffer = std::shared_ptr<GLBuffer>(
+          GLBuffer::CreateVertexBuffer(m_GLHandle, corners, GL_STATIC_DRAW));
+      m_QuadIndexBuffer = std::shared_ptr<GLBuffer>(
+          GLBuffer::CreateIndexBuffer(m_GLHandle, quadIndices,
+              GL_STATIC_DRAW));
+
+      m_InstanceBuffer = std::shared_ptr<GLBuffer>(
+          GLBuffer::CreateStreamingVertexBuffer(
+              m_GLHandle, StreamedBatches * BatchSize * m_InstanceByteSize));
+      return;
+    }
+
+    shaderManager->InitializeTextureShader(m_MaxBatchTextures);
+    shaderManager->UseTextureShader().SetSamplerUnits();
+
     gsl::span<const uint8_t> indices(
         reinterpret_cast<const uint8_t*>(m_Indices.data()),
         m_Indices.size() * sizeof(uint16_t));
 
-    gsl::span<const uint8_t> vertices(
-        reinterpret_cast<const uint8_t*>(m_Vertices.data()),
-        m_Vertices.size() * sizeof(uint8_t));
-
     m_IndexBuffer = std::shared_ptr<GLBuffer>(
         GLBuffer::CreateIndexBuffer(m_GLHandle, indices, GL_STATIC_DRAW));
 
     m_VertexBuffer = std::shared_ptr<GLBuffer>(
-        GLBuffer::CreateVertexBuffer(m_GLHandle, vertices, GL_DYNAMIC_DRAW));
+        GLBuffer::CreateStreamingVertexBuffer(
+            m_GLHandle, StreamedBatches * m_Vertices.size()));
+
+    if(m_Renderer->m_Settings.RetainedSprites) {
+      m_VertexPool = std::make_shared<SpriteVertexPool>(
+          m_GLHandle, 4 * m_VertexByteSize);
+
+      m_DirtyRecords.reserve(BatchSize);
+      m_SlotIndices.reserve(m_Indices.size());
+    }
   }
 
   SpriteRenderer::~SpriteRenderer() = default;
@@ -56,148 +116,552 @@ namespace neonGX {
     }
   }
 
+  void SpriteRenderer::BeginFrame() {
+    m_SlotIndexFlush = 0;
+  }
+
   void SpriteRenderer::Start() {
     WebGLContextRAII switchCtx(m_GLHandle);
 
-    auto& textureShader = m_Renderer->m_ShaderManager->UseTextureShader();
+    if(m_Instanced) {
+      auto& shader = m_Renderer->m_ShaderManager->UseInstancedTextureShader();
+      m_QuadVertexBuffer->Bind();
+      m_QuadIndexBuffer->Bind();
+
+      m_Renderer->m_ShaderManager->ActivateShaderAttributes();
+
+      glVertexAttribPointer(
+          shader.m_shaderAttributes["aQuadCorner"].Location,
+          2, GL_FLOAT, GL_FALSE, 0, nullptr);
+      SetInstanceDivisors(1);
+
+      m_Renderer->m_StateCache->ActiveTexture(0);
+      return;
+    }
+
+    m_Renderer->m_ShaderManager->UseTextureShader();
     m_VertexBuffer->Bind();
     m_IndexBuffer->Bind();
 
     m_Renderer->m_ShaderManager->ActivateShaderAttributes();
 
+    m_Renderer->m_StateCache->ActiveTexture(0);
+  }
+
+  void SpriteRenderer::SetVertexAttributes(size_t baseOffset) {
+    auto& textureShader = m_Renderer->m_ShaderManager->UseTextureShader();
+
     glVertexAttribPointer(
         textureShader.m_shaderAttributes["aVertexPosition"].Location,
-        2, GL_FLOAT, GL_FALSE, VertexByteSize,
-        reinterpret_cast<const void*>(0));
+        2, GL_FLOAT, GL_FALSE, GLsizei(m_VertexByteSize),
+        reinterpret_cast<const void*>(baseOffset));
+
+    if(m_CompactVertices) {
+      glVertexAttribPointer(
+          textureShader.m_shaderAttributes["aTextureCoord"].Location,
+          2, GL_UNSIGNED_SHORT, GL_TRUE, CompactVertexByteSize,
+          reinterpret_cast<const void*>(baseOffset + 8));
+      glVertexAttribPointer(
+          textureShader.m_shaderAttributes["aColor"].Location,
+          4, GL_UNSIGNED_BYTE, GL_TRUE, CompactVertexByteSize,
+          reinterpret_cast<const void*>(baseOffset + 12));
+      glVertexAttribPointer(
+          textureShader.m_shaderAttributes["aTextureId"].Location,
+          1, GL_UNSIGNED_BYTE, GL_FALSE, CompactVertexByteSize,
+          reinterpret_cast<const void*>(baseOffset + 16));
+      return;
+    }
+
     glVertexAttribPointer(
         textureShader.m_shaderAttributes["aTextureCoord"].Location,
         2, GL_FLOAT, GL_FALSE, VertexByteSize,
-        reinterpret_cast<const void*>(2 * sizeof(float)));
+        reinterpret_cast<const void*>(baseOffset + 2 * sizeof(float)));
     glVertexAttribPointer(
         textureShader.m_shaderAttributes["aColor"].Location,
         4, GL_UNSIGNED_BYTE, GL_TRUE, VertexByteSize,
-        reinterpret_cast<const void*>(4 * sizeof(float)));
-
-    glActiveTexture(GL_TEXTURE0);
+        reinterpret_cast<const void*>(baseOffset + 4 * sizeof(float)));
+    glVertexAttribPointer(
+        textureShader.m_shaderAttributes["aTextureId"].Location,
+        1, GL_FLOAT, GL_FALSE, VertexByteSize,
+        reinterpret_cast<const void*>(baseOffset + 5 * sizeof(float)));
   }
 
-  void SpriteRenderer::Stop() {
-    Flush();
+  bool SpriteRenderer::UpdateVertexPool() {
+    bool allRetained = true;
+    m_DirtyRecords.clear();
+
+    for(const SpriteVertexRecord& record : m_Records) {
+      if(record.VertexSlot == SpriteVertexPool::InvalidSlot) {
+        allRetained = false;
+        continue;
+      }
+
+      m_VertexPool->SetTextureId(record.VertexSlot,
+          uint8_t(record.TextureId));
+
+      // Only sprites which changed since their slot was written are packed.
+      if(record.VertexSlotDirty) {
+        m_DirtyRecords.push_back(record);
+      }
+    }
+
+    PackRecords(m_DirtyRecords);
+
+    size_t slotByteSize = 4 * m_VertexByteSize;
+    for(size_t i = 0; i < m_DirtyRecords.size(); i++) {
+      gsl::span<const uint8_t> vertices(
+          m_Vertices.data() + i * slotByteSize, slotByteSize);
+      m_VertexPool->Update(m_DirtyRecords[i].VertexSlot, vertices);
+    }
+
+    m_VertexPool->Upload();
+
+    return allRetained;
   }
 
-  void SpriteRenderer::Flush() {
-    if(m_Sprites.size() == 0) {
+  void SpriteRenderer::UploadSlotIndices() {
+    m_SlotIndices.clear();
+
+    for(const SpriteVertexRecord& record : m_Records) {
+      uint16_t j = uint16_t(record.VertexSlot * 4);
+      m_SlotIndices.insert(m_SlotIndices.end(), {
+          uint16_t(j + 0), uint16_t(j + 1), uint16_t(j + 2),
+          uint16_t(j + 0), uint16_t(j + 2), uint16_t(j + 3)
+      });
+    }
+
+    if(m_SlotIndexFlush == m_SlotIndexLists.size()) {
+      gsl::span<const uint8_t> indices(
+          reinterpret_cast<const uint8_t*>(m_Indices.data()),
+          m_Indices.size() * sizeof(uint16_t));
+
+      m_SlotIndexLists.push_back(SlotIndexList{
+          std::shared_ptr<GLBuffer>(GLBuffer::CreateIndexBuffer(
+              m_GLHandle, indices, GL_DYNAMIC_DRAW)),
+          m_Indices
+      });
+    }
+
+    SlotIndexList& list = m_SlotIndexLists[m_SlotIndexFlush++];
+    list.Buffer->Bind();
+
+    // A static scene produces the very same index lists every frame.
+    if(std::equal(m_SlotIndices.begin(), m_SlotIndices.end(),
+                  list.Uploaded.begin())) {
       return;
     }
 
-    WebGLContextRAII switchCtx(m_GLHandle);
+    std::copy(m_SlotIndices.begin(), m_SlotIndices.end(),
+        list.Uploaded.begin());
+
+    gsl::span<const uint8_t> indices(
+        reinterpret_cast<const uint8_t*>(m_SlotIndices.data()),
+        m_SlotIndices.size() * sizeof(uint16_t));
+    list.Buffer->UploadSubData(indices, true);
+  }
+
+  void SpriteRenderer::BuildBatches() {
+    // A batch only has to be broken up once all texture units are taken.
+    m_Batches.clear();
+    m_Batches.emplace_back();
+
+    for(size_t i = 0; i < m_Records.size(); i++) {
+      SpriteVertexRecord& record = m_Records[i];
+      SpriteBatch* batch = &m_Batches.back();
+
+      auto texturesEnd = batch->Textures.begin() + batch->TextureCount;
+      auto textureIt = std::find(batch->Textures.begin(), texturesEnd,
+          record.Texture);
+
+      if(textureIt == texturesEnd) {
+        if(batch->TextureCount == m_MaxBatchTextures) {
+          m_Batches.emplace_back();
+          batch = &m_Batches.back();
+          batch->Start = i;
+        }
+
+        textureIt = batch->Textures.begin() + batch->TextureCount;
+        *textureIt = record.Texture;
+        batch->TextureCount++;
+      }
+
+      batch->Size++;
+      record.TextureId = float(textureIt - batch->Textures.begin());
+    }
+  }
+
+  static inline bool RecordOverlaps(const SpriteVertexRecord& record,
+                                    float minX, float minY,
+                                    float maxX, float maxY) {
+    const auto& p = record.Positions;
+    float recordMinX = std::min({p[0], p[2], p[4], p[6]});
+    float recordMaxX = std::max({p[0], p[2], p[4], p[6]});
+    float recordMinY = std::min({p[1], p[3], p[5], p[7]});
+    float recordMaxY = std::max({p[1], p[3], p[5], p[7]});
+
+    // Touching edges don't overlap.
+    return recordMinX < maxX && minX < recordMaxX &&
+        recordMinY < maxY && minY < recordMaxY;
+  }
+
+  void SpriteRenderer::ReorderRecords() {
+    m_ReorderGroups.clear();
+    m_RecordGroups.clear();
+
+    for(const SpriteVertexRecord& record : m_Records) {
+      // Walk back over the groups which don't overlap the sprite and remember
+      // the earliest one that already samples its texture. The sprite is
+      // then drawn after all members of that group but before every group it
+      // skipped, which can't change the visual result.
+      size_t target = m_ReorderGroups.size();
+      size_t windowEnd = m_ReorderGroups.size() > ReorderWindow ?
+          m_ReorderGroups.size() - ReorderWindow : 0;
+
+      for(size_t g = m_ReorderGroups.size(); g > windowEnd; g--) {
+        const ReorderGroup& group = m_ReorderGroups[g - 1];
+        auto texturesEnd = group.Textures.begin() + group.TextureCount;
+
+        if(std::find(group.Textures.begin(), texturesEnd, record.Texture) !=
+           texturesEnd) {
+          target = g - 1;
+        }
+
+        if(RecordOverlaps(record, group.MinX, group.MinY,
+                          group.MaxX, group.MaxY)) {
+          break;
+        }
+      }
+
+      if(target == m_ReorderGroups.size()) {
+        if(m_ReorderGroups.empty() ||
+           m_ReorderGroups.back().TextureCount == m_MaxBatchTextures) {
+          m_ReorderGroups.emplace_back();
+          ReorderGroup& group = m_ReorderGroups.back();
+          group.MinX = group.MinY = std::numeric_limits<float>::max();
+          group.MaxX = group.MaxY = std::numeric_limits<float>::lowest();
+        }
+
+        target = m_ReorderGroups.size() - 1;
+        ReorderGroup& group = m_ReorderGroups.back();
+        auto texturesEnd = group.Textures.begin() + group.TextureCount;
+
+        if(std::find(group.Textures.begin(), texturesEnd, record.Texture) ==
+           texturesEnd) {
+          group.Textures[group.TextureCount++] = record.Texture;
+        }
+      }
 
-    float* floatView = reinterpret_cast<float*>(m_Vertices.data());
-    uint32_t* uint32View = reinterpret_cast<uint32_t*>(m_Vertices.data());
+      ReorderGroup& group = m_ReorderGroups[target];
+      const auto& p = record.Positions;
+      group.MinX = std::min({group.MinX, p[0], p[2], p[4], p[6]});
+      group.MaxX = std::max({group.MaxX, p[0], p[2], p[4], p[6]});
+      group.MinY = std::min({group.MinY, p[1], p[3], p[5], p[7]});
+      group.MaxY = std::max({group.MaxY, p[1], p[3], p[5], p[7]});
+      group.Size++;
 
-    size_t bufferIndex = 0;
+      m_RecordGroups.push_back(uint32_t(target));
+    }
 
-    for(auto sprite : m_Sprites) {
-      uint32_t tint = (sprite->m_Tint >> 16) +
-          (sprite->m_Tint & 0xFF00) +
-          ((sprite->m_Tint & 0xFF) << 16) +
-          (uint32_t(sprite->m_WorldAlpha * 255) << 24);
+    if(m_ReorderGroups.size() == 1) {
+      return;
+    }
 
-      TextureUVs& uvs = sprite->m_Texture->GetUVs();
+    // Stable counting sort of the sprites by group.
+    size_t offset = 0;
+    for(ReorderGroup& group : m_ReorderGroups) {
+      size_t size = group.Size;
+      group.Size = offset;
+      offset += size;
+    }
 
-      floatView[bufferIndex++] = sprite->m_VertexData[0];
-      floatView[bufferIndex++] = sprite->m_VertexData[1];
-      floatView[bufferIndex++] = uvs.P0.x;
-      floatView[bufferIndex++] = uvs.P0.y;
-      uint32View[bufferIndex++] = tint;
+    m_SortedRecords.resize(m_Records.size());
 
-      floatView[bufferIndex++] = sprite->m_VertexData[2];
-      floatView[bufferIndex++] = sprite->m_VertexData[3];
-      floatView[bufferIndex++] = uvs.P1.x;
-      floatView[bufferIndex++] = uvs.P1.y;
-      uint32View[bufferIndex++] = tint;
+    size_t movedSprites = 0;
+    for(size_t i = 0; i < m_Records.size(); i++) {
+      size_t dest = m_ReorderGroups[m_RecordGroups[i]].Size++;
+      m_SortedRecords[dest] = m_Records[i];
+      movedSprites += (dest != i) ? 1 : 0;
+    }
 
-      floatView[bufferIndex++] = sprite->m_VertexData[4];
-      floatView[bufferIndex++] = sprite->m_VertexData[5];
-      floatView[bufferIndex++] = uvs.P2.x;
-      floatView[bufferIndex++] = uvs.P2.y;
-      uint32View[bufferIndex++] = tint;
+    m_Records.swap(m_SortedRecords);
+    m_Renderer->m_Stats.ReorderedSprites += movedSprites;
+  }
+
+  void SpriteRenderer::SetInstanceAttributes(size_t baseOffset) {
+    auto& shader = m_Renderer->m_ShaderManager->UseInstancedTextureShader();
 
-      floatView[bufferIndex++] = sprite->m_VertexData[6];
-      floatView[bufferIndex++] = sprite->m_VertexData[7];
-      floatView[bufferIndex++] = uvs.P3.x;
-      floatView[bufferIndex++] = uvs.P3.y;
-      uint32View[bufferIndex++] = tint;
+    glVertexAttribPointer(
+        shader.m_shaderAttributes["aTranslation"].Location,
+        2, GL_FLOAT, GL_FALSE, GLsizei(m_InstanceByteSize),
+        reinterpret_cast<const void*>(baseOffset));
+    glVertexAttribPointer(
+        shader.m_shaderAttributes["aTransform"].Location,
+        4, GL_FLOAT, GL_FALSE, GLsizei(m_InstanceByteSize),
+        reinterpret_cast<const void*>(baseOffset + 2 * sizeof(float)));
+
+    if(m_CompactVertices) {
+      glVertexAttribPointer(
+          shader.m_shaderAttributes["aFrame"].Location,
+          4, GL_UNSIGNED_SHORT, GL_TRUE, CompactInstanceByteSize,
+          reinterpret_cast<const void*>(baseOffset + 24));
+      glVertexAttribPointer(
+          shader.m_shaderAttributes["aColor"].Location,
+          4, GL_UNSIGNED_BYTE, GL_TRUE, CompactInstanceByteSize,
+          reinterpret_cast<const void*>(baseOffset + 32));
+      glVertexAttribPointer(
+          shader.m_shaderAttributes["aTextureId"].Location,
+          1, GL_UNSIGNED_BYTE, GL_FALSE, CompactInstanceByteSize,
+          reinterpret_cast<const void*>(baseOffset + 36));
+      return;
     }
 
-    size_t batchDataSize = m_Sprites.size() * VertexByteSize * 4;
-    gsl::span<const uint8_t> tmpSpan(m_Vertices.data(), batchDataSize);
+    glVertexAttribPointer(
+        shader.m_shaderAttributes["aFrame"].Location,
+        4, GL_FLOAT, GL_FALSE, InstanceByteSize,
+        reinterpret_cast<const void*>(baseOffset + 6 * sizeof(float)));
+    glVertexAttribPointer(
+        shader.m_shaderAttributes["aColor"].Location,
+        4, GL_UNSIGNED_BYTE, GL_TRUE, InstanceByteSize,
+        reinterpret_cast<const void*>(baseOffset + 10 * sizeof(float)));
+    glVertexAttribPointer(
+        shader.m_shaderAttributes["aTextureId"].Location,
+        1, GL_FLOAT, GL_FALSE, InstanceByteSize,
+        reinterpret_cast<const void*>(baseOffset + 11 * sizeof(float)));
+  }
 
-    m_VertexBuffer->UploadSubData(tmpSpan);
+  void SpriteRenderer::SetInstanceDivisors(GLuint divisor) {
+    auto& shader = m_Renderer->m_ShaderManager->UseInstancedTextureShader();
+    const auto& extensions = m_Renderer->m_Extensions;
 
-    auto renderBatch = [] (webgl_context_handle glHandle,
-                           const std::shared_ptr<BaseTexture>& texture,
-                           size_t size, size_t startIndex) {
-      if(size == 0) {
-        return;
+    for(const auto& it : shader.m_shaderAttributes) {
+      if(it.first != "aQuadCorner") {
+        extensions.VertexAttribDivisor(it.second.Location, divisor);
       }
+    }
+  }
+
+  void SpriteRenderer::BindBatchTextures(const SpriteBatch& batch) {
+    // Creating a GLTexture binds it to the active unit, so every texture
+    // has to exist before the units are populated.
+    std::array<std::shared_ptr<GLTexture>, MaxBatchTextures> glTextures;
+    for(size_t i = 0; i < batch.TextureCount; i++) {
+      glTextures[i] = batch.Textures[i]->GetGLTexture(m_GLHandle);
+    }
 
-      assert(texture.get() != nullptr);
-      texture->GetGLTexture(glHandle)->Bind(nullopt);
+    for(size_t i = 0; i < batch.TextureCount; i++) {
+      glTextures[i]->Bind(GLenum(i));
+    }
+  }
 
-      glDrawElements(GL_TRIANGLES, GLsizei(size * 6), GL_UNSIGNED_SHORT,
-          reinterpret_cast<const void*>(startIndex * 6 * 2));
-    };
+  void SpriteRenderer::PackRecords(
+      const std::vector<SpriteVertexRecord>& records) {
+    using PackFunction =
+        void (*)(const SpriteVertexRecord*, size_t, uint8_t*);
+
+    PackFunction pack;
+    size_t recordByteSize;
+
+    if(m_Instanced) {
+      pack = m_CompactVertices ?
+          PackSpriteInstancesCompact : PackSpriteInstances;
+      recordByteSize = m_InstanceByteSize;
+    } else {
+      pack = m_CompactVertices ?
+          PackSpriteVerticesCompact : PackSpriteVertices;
+      recordByteSize = 4 * m_VertexByteSize;
+    }
+
+    WorkerPool* workers = m_Renderer->GetBatchWorkers();
+    if(!workers) {
+      pack(records.data(), records.size(), m_Vertices.data());
+      return;
+    }
+
+    // Every job writes the disjoint byte range of its records.
+    workers->ParallelFor(records.size(), PackGrain,
+        [&](size_t begin, size_t end) {
+      pack(records.data() + begin, end - begin,
+          m_Vertices.data() + begin * recordByteSize);
+    });
+  }
+
+  void SpriteRenderer::Stop() {
+    Flush();
+
+    // Divisors are per attribute location, not per program.
+    if(m_Instanced) {
+      SetInstanceDivisors(0);
+    }
+  }
+
+  void SpriteRenderer::Flush() {
+    if(m_Records.size() == 0) {
+      return;
+    }
+
+    WebGLContextRAII switchCtx(m_GLHandle);
+
+    BuildBatches();
+
+    if(m_ReorderBatches && m_Batches.size() > 1) {
+      size_t paintersOrderBatches = m_Batches.size();
+
+      ReorderRecords();
+      BuildBatches();
+
+      m_Renderer->m_Stats.ReorderSavedDrawCalls +=
+          paintersOrderBatches - m_Batches.size();
+    }
+
+    auto& stats = m_Renderer->m_Stats;
+    stats.Flushes++;
 
 #ifdef NEONGX_USE_EMSCRIPTEN
-    glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+    m_Renderer->m_StateCache->BlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
 #else
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    m_Renderer->m_StateCache->BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 #endif
 
-    auto& textureShader = m_Renderer->m_ShaderManager->UseTextureShader();
-    textureShader.SetProjectionMatrix(
-        m_Renderer->m_RenderTarget->m_ProjectionMatrix);
+    if(m_Instanced) {
+      PackRecords(m_Records);
 
-    size_t batchSize = 0;
-    size_t startBatch = 0;
+      gsl::span<const uint8_t> tmpSpan(m_Vertices.data(),
+          m_Records.size() * m_InstanceByteSize);
+      size_t baseOffset = m_InstanceBuffer->StreamData(tmpSpan);
 
-    std::shared_ptr<BaseTexture> currentBaseTexture;
-    std::shared_ptr<BaseTexture> nextBaseTexture;
+      auto& shader = m_Renderer->m_ShaderManager->UseInstancedTextureShader();
+      shader.SetProjectionMatrix(
+          m_Renderer->m_CurrentRenderTarget->m_ProjectionMatrix);
 
-    for(size_t i = 0; i < m_Sprites.size(); i++) {
-      auto sprite = m_Sprites[i];
+      // There is no base instance in GLES2, every batch re-points the
+      // instance attributes instead.
+      for(auto& batch : m_Batches) {
+        if(batch.Size == 0) {
+          continue;
+        }
 
-      nextBaseTexture = sprite->m_Texture->GetBaseTexture();
+        stats.DrawCalls++;
 
-      if(currentBaseTexture != nextBaseTexture) {
-        renderBatch(m_GLHandle, currentBaseTexture, batchSize, startBatch);
+        BindBatchTextures(batch);
+        SetInstanceAttributes(baseOffset + batch.Start * m_InstanceByteSize);
 
-        startBatch = i;
-        batchSize = 0;
-        currentBaseTexture = nextBaseTexture;
+        m_Renderer->m_Extensions.DrawElementsInstanced(GL_TRIANGLES, 6,
+            GL_UNSIGNED_SHORT, nullptr, GLsizei(batch.Size));
+      }
+    } else {
+      // Sprites without a slot (the pool is exhausted) force the whole
+      // flush onto the streaming path.
+      if(m_VertexPool && UpdateVertexPool()) {
+        m_VertexPool->GetVertexBuffer().Bind();
+        SetVertexAttributes(0);
+
+        auto& textureShader =
+            m_Renderer->m_ShaderManager->UseTextureShader();
+        m_VertexPool->GetTextureIdBuffer().Bind();
+        glVertexAttribPointer(
+            textureShader.m_shaderAttributes["aTextureId"].Location,
+            1, GL_UNSIGNED_BYTE, GL_FALSE, 0, nullptr);
+
+        UploadSlotIndices();
+      } else {
+        PackRecords(m_Records);
+
+        size_t batchDataSize = m_Records.size() * m_VertexByteSize * 4;
+        gsl::span<const uint8_t> tmpSpan(m_Vertices.data(), batchDataSize);
+
+        size_t baseOffset = m_VertexBuffer->StreamData(tmpSpan);
+        SetVertexAttributes(baseOffset);
+        m_IndexBuffer->Bind();
       }
 
-      batchSize++;
+      auto& textureShader = m_Renderer->m_ShaderManager->UseTextureShader();
+      textureShader.SetProjectionMatrix(
+          m_Renderer->m_CurrentRenderTarget->m_ProjectionMatrix);
+
+      for(auto& batch : m_Batches) {
+        if(batch.Size == 0) {
+          continue;
+        }
+
+        stats.DrawCalls++;
+
+        BindBatchTextures(batch);
+
+        glDrawElements(GL_TRIANGLES, GLsizei(batch.Size * 6),
+            GL_UNSIGNED_SHORT,
+            reinterpret_cast<const void*>(batch.Start * 6 * 2));
+      }
     }
 
-    renderBatch(m_GLHandle, currentBaseTexture, batchSize, startBatch);
+    m_Renderer->m_StateCache->ActiveTexture(0);
 
-    m_Sprites.clear();
+    m_Records.clear();
   }
 
-  void SpriteRenderer::Render(DisplayObject *object) {
-    assert(m_Sprites.size() <= BatchSize);
+  void SpriteRenderer::CaptureRecord(const Sprite& sprite,
+                                     SpriteVertexRecord& record) {
+    assert(sprite.m_Texture->IsValid());
+
+    const TextureUVs& uvs = sprite.m_Texture->GetUVs();
 
-    if(m_Sprites.size() == BatchSize) {
+    record.Positions = sprite.m_VertexData;
+    record.UVs = {
+        uvs.P0.x, uvs.P0.y, uvs.P1.x, uvs.P1.y,
+        uvs.P2.x, uvs.P2.y, uvs.P3.x, uvs.P3.y
+    };
+    record.Tint = sprite.m_Tint;
+    record.Alpha = sprite.m_WorldAlpha;
+    record.TextureId = 0.0f;
+    record.Texture = sprite.m_Texture->GetBaseTexture().get();
+    assert(record.Texture != nullptr);
+
+    record.VertexSlot = SpriteVertexPool::InvalidSlot;
+    record.VertexSlotDirty = true;
+  }
+
+  void SpriteRenderer::RenderRecord(const SpriteVertexRecord& record) {
+    assert(m_Records.size() <= BatchSize);
+
+    if(m_Records.size() == BatchSize) {
       Flush();
     }
 
+    m_Renderer->m_Stats.Sprites++;
+    m_Records.push_back(record);
+  }
+
+  void SpriteRenderer::Render(DisplayObject *object) {
     auto* sprite = dynamic_cast<Sprite*>(object);
     assert(sprite != nullptr);
-    assert(sprite->m_Texture->IsValid());
 
-    m_Sprites.push_back(sprite);
+    SpriteVertexRecord record;
+    CaptureRecord(*sprite, record);
+
+    if(m_VertexPool) {
+      auto spritePool = sprite->m_VertexPool.lock();
+
+      if(spritePool != m_VertexPool ||
+         sprite->m_VertexSlot == SpriteVertexPool::InvalidSlot) {
+        if(spritePool &&
+           sprite->m_VertexSlot != SpriteVertexPool::InvalidSlot) {
+          spritePool->Free(sprite->m_VertexSlot);
+        }
+
+        sprite->m_VertexPool = m_VertexPool;
+        sprite->m_VertexSlot = m_VertexPool->Allocate();
+        sprite->m_VertexSlotDirty = true;
+      }
+
+      // New vertices or a changed world alpha, which only bumps the world
+      // version, require the slot to be packed again.
+      record.VertexSlot = sprite->m_VertexSlot;
+      record.VertexSlotDirty = sprite->m_VertexSlotDirty ||
+          sprite->m_VertexSlotVersion != sprite->m_WorldVersion;
+      sprite->m_VertexSlotDirty = false;
+      sprite->m_VertexSlotVersion = sprite->m_WorldVersion;
+    }
+
+    RenderRecord(record);
   }
 
 }
@@ -0,0 +1,263 @@
+/*
+ * neonGX - SpriteVertexPacker.cpp
+ *
+ * Copyright (c) 2016, cynecx
+ *
+ * This file is part of neonGX and is distributed under a modified
+ * BSD 3-Clause License. See LICENSE.txt for details.
+ *
+ */
+
+#include <neonGX/Core/Sprites/SpriteVertexPacker.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define NEONGX_SPRITE_PACKER_SSE2
+#elif defined(__wasm_simd128__)
+#include <wasm_simd128.h>
+#define NEONGX_SPRITE_PACKER_WASM_SIMD
+#endif
+
+namespace neonGX {
+
+  // Bytes written per sprite: 4 vertices * 6 components * 4 bytes
+  static constexpr size_t SpriteByteSize = 4 * 6 * sizeof(float);
+
+  static inline uint32_t PackColor(uint32_t tint, float alpha) {
+    return (tint >> 16) +
+        (tint & 0xFF00) +
+        ((tint & 0xFF) << 16) +
+        (uint32_t(alpha * 255) << 24);
+  }
+
+  void PackSpriteVerticesScalar(const SpriteVertexRecord* records,
+                                size_t count, uint8_t* output) {
+    float* floatView = reinterpret_cast<float*>(output);
+    uint32_t* uint32View = reinterpret_cast<uint32_t*>(output);
+
+    size_t bufferIndex = 0;
+
+    for(size_t i = 0; i < count; i++) {
+      const SpriteVertexRecord& record = records[i];
+      uint32_t color = PackColor(record.Tint, record.Alpha);
+
+      for(size_t corner = 0; corner < 8; corner += 2) {
+        floatView[bufferIndex++] = record.Positions[corner];
+        floatView[bufferIndex++] = record.Positions[corner + 1];
+        floatView[bufferIndex++] = record.UVs[corner];
+        floatView[bufferIndex++] = record.UVs[corner + 1];
+        uint32View[bufferIndex++] = color;
+        floatView[bufferIndex++] = record.TextureId;
+      }
+    }
+  }
+
+  void PackSpriteInstances(const SpriteVertexRecord* records, size_t count,
+                           uint8_t* output) {
+    float* floatView = reinterpret_cast<float*>(output);
+    uint32_t* uint32View = reinterpret_cast<uint32_t*>(output);
+
+    size_t bufferIndex = 0;
+
+    for(size_t i = 0; i < count; i++) {
+      const SpriteVertexRecord& record = records[i];
+      const auto& p = record.Positions;
+
+      floatView[bufferIndex++] = p[0];
+      floatView[bufferIndex++] = p[1];
+      floatView[bufferIndex++] = p[2] - p[0];
+      floatView[bufferIndex++] = p[3] - p[1];
+      floatView[bufferIndex++] = p[6] - p[0];
+      floatView[bufferIndex++] = p[7] - p[1];
+
+      floatView[bufferIndex++] = record.UVs[0];
+      floatView[bufferIndex++] = record.UVs[1];
+      floatView[bufferIndex++] = record.UVs[4];
+      floatView[bufferIndex++] = record.UVs[5];
+
+      uint32View[bufferIndex++] = PackColor(record.Tint, record.Alpha);
+      floatView[bufferIndex++] = record.TextureId;
+    }
+  }
+
+  static inline uint16_t NormalizeUV(float value) {
+    return uint16_t(std::lround(std::min(std::max(value, 0.0f), 1.0f) *
+        65535.0f));
+  }
+
+  static inline uint8_t* WriteFloat(uint8_t* output, float value) {
+    std::memcpy(output, &value, sizeof(float));
+    return output + sizeof(float);
+  }
+
+  static inline uint8_t* WriteUV(uint8_t* output, float u, float v) {
+    uint16_t uv[2] = { NormalizeUV(u), NormalizeUV(v) };
+    std::memcpy(output, uv, sizeof(uv));
+    return output + sizeof(uv);
+  }
+
+  static inline uint8_t* WriteColorAndId(uint8_t* output, uint32_t color,
+                                         float textureId) {
+    uint8_t id[4] = { uint8_t(textureId), 0, 0, 0 };
+    std::memcpy(output, &color, sizeof(uint32_t));
+    std::memcpy(output + sizeof(uint32_t), id, sizeof(id));
+    return output + sizeof(uint32_t) + sizeof(id);
+  }
+
+  void PackSpriteVerticesCompact(const SpriteVertexRecord* records,
+                                 size_t count, uint8_t* output) {
+    for(size_t i = 0; i < count; i++) {
+      const SpriteVertexRecord& record = records[i];
+      uint32_t color = PackColor(record.Tint, record.Alpha);
+
+      for(size_t corner = 0; corner < 8; corner += 2) {
+        output = WriteFloat(output, record.Positions[corner]);
+        output = WriteFloat(output, record.Positions[corner + 1]);
+        output = WriteUV(output, record.UVs[corner], record.UVs[corner + 1]);
+        output = WriteColorAndId(output, color, record.TextureId);
+      }
+    }
+  }
+
+  void PackSpriteInstancesCompact(const SpriteVertexRecord* records,
+                                  size_t count, uint8_t* output) {
+    for(size_t i = 0; i < count; i++) {
+      const SpriteVertexRecord& record = records[i];
+      const auto& p = record.Positions;
+
+      output = WriteFloat(output, p[0]);
+      output = WriteFloat(output, p[1]);
+      output = WriteFloat(output, p[2] - p[0]);
+      output = WriteFloat(output, p[3] - p[1]);
+      output = WriteFloat(output, p[6] - p[0]);
+      output = WriteFloat(output, p[7] - p[1]);
+
+      output = WriteUV(output, record.UVs[0], record.UVs[1]);
+      output = WriteUV(output, record.UVs[4], record.UVs[5]);
+
+      output = WriteColorAndId(output,
+          PackColor(record.Tint, record.Alpha), record.TextureId);
+    }
+  }
+
+#if defined(NEONGX_SPRITE_PACKER_SSE2)
+  // pos = {xa, ya, xb, yb}, uv = {ua, va, ub, vb}, tail = {c, id, c, id}
+  // -> {xa, ya, ua, va}, {c, id, xb, yb}, {ub, vb, c, id}
+  static inline void StoreVertexPair(float* out, __m128 pos, __m128 uv,
+                                     __m128 tail) {
+    _mm_storeu_ps(out + 0, _mm_movelh_ps(pos, uv));
+    _mm_storeu_ps(out + 4, _mm_shuffle_ps(tail, pos, _MM_SHUFFLE(3, 2, 1, 0)));
+    _mm_storeu_ps(out + 8, _mm_shuffle_ps(uv, tail, _MM_SHUFFLE(1, 0, 3, 2)));
+  }
+
+  static inline void PackSprite(const SpriteVertexRecord& record,
+                                uint32_t color, float* out) {
+    __m128 tail = _mm_unpacklo_ps(
+        _mm_castsi128_ps(_mm_set1_epi32(int32_t(color))),
+        _mm_set1_ps(record.TextureId));
+
+    StoreVertexPair(out, _mm_load_ps(record.Positions.data()),
+        _mm_load_ps(record.UVs.data()), tail);
+    StoreVertexPair(out + 12, _mm_load_ps(record.Positions.data() + 4),
+        _mm_load_ps(record.UVs.data() + 4), tail);
+  }
+
+  void PackSpriteVertices(const SpriteVertexRecord* records, size_t count,
+                          uint8_t* output) {
+    size_t i = 0;
+
+    for(; i + 4 <= count; i += 4) {
+      const SpriteVertexRecord* r = records + i;
+
+      // Swizzle the tints to ABGR and apply the alpha of 4 sprites at once.
+      __m128i tint = _mm_set_epi32(int32_t(r[3].Tint), int32_t(r[2].Tint),
+          int32_t(r[1].Tint), int32_t(r[0].Tint));
+      __m128 alpha = _mm_set_ps(r[3].Alpha, r[2].Alpha, r[1].Alpha,
+          r[0].Alpha);
+
+      __m128i color = _mm_add_epi32(
+          _mm_add_epi32(_mm_srli_epi32(tint, 16),
+              _mm_and_si128(tint, _mm_set1_epi32(0xFF00))),
+          _mm_add_epi32(
+              _mm_slli_epi32(_mm_and_si128(tint, _mm_set1_epi32(0xFF)), 16),
+              _mm_slli_epi32(_mm_cvttps_epi32(
+                  _mm_mul_ps(alpha, _mm_set1_ps(255.0f))), 24)));
+
+      alignas(16) uint32_t colors[4];
+      _mm_store_si128(reinterpret_cast<__m128i*>(colors), color);
+
+      float* out = reinterpret_cast<float*>(output + i * SpriteByteSize);
+      PackSprite(r[0], colors[0], out);
+      PackSprite(r[1], colors[1], out + 24);
+      PackSprite(r[2], colors[2], out + 48);
+      PackSprite(r[3], colors[3], out + 72);
+    }
+
+    for(; i < count; i++) {
+      PackSprite(records[i], PackColor(records[i].Tint, records[i].Alpha),
+          reinterpret_cast<float*>(output + i * SpriteByteSize));
+    }
+  }
+#elif defined(NEONGX_SPRITE_PACKER_WASM_SIMD)
+  // Same lane layout as the SSE2 variant.
+  static inline void StoreVertexPair(float* out, v128_t pos, v128_t uv,
+                                     v128_t tail) {
+    wasm_v128_store(out + 0, wasm_i32x4_shuffle(pos, uv, 0, 1, 4, 5));
+    wasm_v128_store(out + 4, wasm_i32x4_shuffle(tail, pos, 0, 1, 6, 7));
+    wasm_v128_store(out + 8, wasm_i32x4_shuffle(uv, tail, 2, 3, 4, 5));
+  }
+
+  static inline void PackSprite(const SpriteVertexRecord& record,
+                                uint32_t color, float* out) {
+    v128_t tail = wasm_i32x4_shuffle(wasm_i32x4_splat(int32_t(color)),
+        wasm_f32x4_splat(record.TextureId), 0, 4, 0, 4);
+
+    StoreVertexPair(out, wasm_v128_load(record.Positions.data()),
+        wasm_v128_load(record.UVs.data()), tail);
+    StoreVertexPair(out + 12, wasm_v128_load(record.Positions.data() + 4),
+        wasm_v128_load(record.UVs.data() + 4), tail);
+  }
+
+  void PackSpriteVertices(const SpriteVertexRecord* records, size_t count,
+                          uint8_t* output) {
+    size_t i = 0;
+
+    for(; i + 4 <= count; i += 4) {
+      const SpriteVertexRecord* r = records + i;
+
+      v128_t tint = wasm_i32x4_make(int32_t(r[0].Tint), int32_t(r[1].Tint),
+          int32_t(r[2].Tint), int32_t(r[3].Tint));
+      v128_t alpha = wasm_f32x4_make(r[0].Alpha, r[1].Alpha, r[2].Alpha,
+          r[3].Alpha);
+
+      v128_t color = wasm_i32x4_add(
+          wasm_i32x4_add(wasm_u32x4_shr(tint, 16),
+              wasm_v128_and(tint, wasm_i32x4_splat(0xFF00))),
+          wasm_i32x4_add(
+              wasm_i32x4_shl(wasm_v128_and(tint, wasm_i32x4_splat(0xFF)), 16),
+              wasm_i32x4_shl(wasm_i32x4_trunc_sat_f32x4(
+                  wasm_f32x4_mul(alpha, wasm_f32x4_splat(255.0f))), 24)));
+
+      float* out = reinterpret_cast<float*>(output + i * SpriteByteSize);
+      PackSprite(r[0], uint32_t(wasm_i32x4_extract_lane(color, 0)), out);
+      PackSprite(r[1], uint32_t(wasm_i32x4_extract_lane(color, 1)), out + 24);
+      PackSprite(r[2], uint32_t(wasm_i32x4_extract_lane(color, 2)), out + 48);
+      PackSprite(r[3], uint32_t(wasm_i32x4_extract_lane(color, 3)), out + 72);
+    }
+
+    for(; i < count; i++) {
+      PackSprite(records[i], PackColor(records[i].Tint, records[i].Alpha),
+          reinterpret_cast<float*>(output + i * SpriteByteSize));
+    }
+  }
+#else
+  void PackSpriteVertices(const SpriteVertexRecord* records, size_t count,
+                          uint8_t* output) {
+    PackSpriteVerticesScalar(records, count, output);
+  }
+#endif
+
+}
@@ -0,0 +1,135 @@
+/*
+ * neonGX - SpriteVertexPool.cpp
+ *
+ * Copyright (c) 2016, cynecx
+ *
+ * This file is part of neonGX and is distributed under a modified
+ * BSD 3-Clause License. See LICENSE.txt for details.
+ *
+ */
+
+#include <neonGX/Core/Sprites/SpriteVertexPool.hpp>
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+namespace neonGX {
+
+  void SpriteVertexPool::SlotStore::Resize(size_t slotCount) {
+    Data.resize(slotCount * SlotByteSize);
+    SlotQueued.resize(slotCount, false);
+    Reallocated = true;
+  }
+
+  void SpriteVertexPool::SlotStore::MarkDirty(uint32_t slot) {
+    if(!SlotQueued[slot]) {
+      SlotQueued[slot] = true;
+      DirtySlots.push_back(slot);
+    }
+  }
+
+  size_t SpriteVertexPool::SlotStore::Upload() {
+    size_t uploadedBytes = 0;
+
+    if(Reallocated) {
+      // The store changed its size, replace it as a whole.
+      Buffer->UploadData(Data);
+      uploadedBytes = Data.size();
+      Reallocated = false;
+    } else if(!DirtySlots.empty()) {
+      std::sort(DirtySlots.begin(), DirtySlots.end());
+
+      Buffer->Bind();
+
+      size_t rangeBegin = DirtySlots.front();
+      size_t rangeEnd = rangeBegin + 1;
+
+      auto uploadRange = [&] (size_t begin, size_t end) {
+        gsl::span<const uint8_t> range(
+            Data.data() + begin * SlotByteSize,
+            (end - begin) * SlotByteSize);
+        Buffer->UploadSubData(range, true, begin * SlotByteSize);
+        uploadedBytes += size_t(range.size_bytes());
+      };
+
+      for(size_t i = 1; i < DirtySlots.size(); i++) {
+        size_t slot = DirtySlots[i];
+        if(slot > rangeEnd + MergeGap) {
+          uploadRange(rangeBegin, rangeEnd);
+          rangeBegin = slot;
+        }
+        rangeEnd = slot + 1;
+      }
+
+      uploadRange(rangeBegin, rangeEnd);
+    }
+
+    for(uint32_t slot : DirtySlots) {
+      SlotQueued[slot] = false;
+    }
+    DirtySlots.clear();
+
+    return uploadedBytes;
+  }
+
+  SpriteVertexPool::SpriteVertexPool(webgl_context_handle glHandle,
+                                     size_t slotByteSize)
+      : m_GLHandle(glHandle) {
+    m_Vertices.SlotByteSize = slotByteSize;
+    m_Vertices.Buffer = std::make_unique<GLBuffer>(
+        m_GLHandle, GL_ARRAY_BUFFER, GL_DYNAMIC_DRAW);
+
+    m_TextureIds.SlotByteSize = 4;
+    m_TextureIds.Buffer = std::make_unique<GLBuffer>(
+        m_GLHandle, GL_ARRAY_BUFFER, GL_DYNAMIC_DRAW);
+  }
+
+  SpriteVertexPool::~SpriteVertexPool() = default;
+
+  void SpriteVertexPool::Grow() {
+    size_t oldCount = m_SlotCount;
+    m_SlotCount = std::min(std::max(m_SlotCount * 2, InitialSlots), MaxSlots);
+
+    m_Vertices.Resize(m_SlotCount);
+    m_TextureIds.Resize(m_SlotCount);
+
+    // Hand out the lowest slots first to keep the dirty ranges dense.
+    for(size_t i = m_SlotCount; i > oldCount; i--) {
+      m_FreeSlots.push_back(uint32_t(i - 1));
+    }
+  }
+
+  uint32_t SpriteVertexPool::Allocate() {
+    if(m_FreeSlots.empty()) {
+      if(m_SlotCount == MaxSlots) {
+        return InvalidSlot;
+      }
+      Grow();
+    }
+
+    uint32_t slot = m_FreeSlots.back();
+    m_FreeSlots.pop_back();
+    return slot;
+  }
+
+  void SpriteVertexPool::Free(uint32_t slot) {
+    assert(slot < m_SlotCount);
+    m_FreeSlots.push_back(slot);
+  }
+
+  void SpriteVertexPool::Update(uint32_t slot,
+                                gsl::span<const uint8_t> vertices) {
+    assert(slot < m_SlotCount);
+    assert(size_t(vertices.size_bytes()) == m_Vertices.SlotByteSize);
+
+    std::memcpy(m_Vertices.GetSlotData(slot), vertices.data(),
+        m_Vertices.SlotByteSize);
+    m_Vertices.MarkDirty(slot);
+  }
+
+  size_t SpriteVertexPool::Upload() {
+    m_UploadedBytes = m_Vertices.Upload() + m_TextureIds.Upload();
+    return m_UploadedBytes;
+  }
+
+}
@@ -0,0 +1,126 @@
+/*
+ * neonGX - DistanceField.cpp
+ *
+ * Copyright (c) 2016, cynecx
+ *
+ * This file is part of neonGX and is distributed under a modified
+ * BSD 3-Clause License. See LICENSE.txt for details.
+ *
+ */
+
+#include <neonGX/Core/Text/DistanceField.hpp>
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace neonGX {
+
+  static constexpr float Infinity = 1e20f;
+
+  // One dimensional squared euclidean distance transform, see Felzenszwalb
+  // and Huttenlocher, "Distance Transforms of Sampled Functions".
+  static void Transform1D(float* f, size_t stride, int32_t n,
+                          std::vector<float>& d, std::vector<int32_t>& v,
+                          std::vector<float>& z) {
+    v[0] = 0;
+    z[0] = -Infinity;
+    z[1] = Infinity;
+
+    // z[0] never exceeds a parabola intersection as f is finite.
+    int32_t k = 0;
+    for(int32_t q = 1; q < n; q++) {
+      float fq = f[size_t(q) * stride] + float(q * q);
+      float s;
+
+      for(;;) {
+        int32_t r = v[size_t(k)];
+        s = (fq - (f[size_t(r) * stride] + float(r * r))) / float(2 * (q - r));
+        if(s > z[size_t(k)]) {
+          break;
+        }
+        k--;
+      }
+
+      k++;
+      v[size_t(k)] = q;
+      z[size_t(k)] = s;
+      z[size_t(k) + 1] = Infinity;
+    }
+
+    k = 0;
+    for(int32_t q = 0; q < n; q++) {
+      while(z[size_t(k) + 1] < float(q)) {
+        k++;
+      }
+      int32_t r = v[size_t(k)];
+      d[size_t(q)] = float((q - r) * (q - r)) + f[size_t(r) * stride];
+    }
+
+    for(int32_t q = 0; q < n; q++) {
+      f[size_t(q) * stride] = d[size_t(q)];
+    }
+  }
+
+  static void Transform2D(std::vector<float>& grid, int32_t width,
+                          int32_t height) {
+    size_t length = size_t(std::max(width, height));
+    std::vector<float> d(length);
+    std::vector<int32_t> v(length);
+    std::vector<float> z(length + 1);
+
+    for(int32_t x = 0; x < width; x++) {
+      Transform1D(grid.data() + x, size_t(width), height, d, v, z);
+    }
+
+    for(int32_t y = 0; y < height; y++) {
+      Transform1D(grid.data() + size_t(y) * size_t(width), 1, width, d, v, z);
+    }
+  }
+
+  std::vector<uint8_t> GenerateDistanceField(const uint8_t* bitmap,
+                                             int32_t width, int32_t height,
+                                             int32_t pitch, int32_t spread) {
+    assert(spread > 0);
+
+    int32_t fieldWidth = width + 2 * spread;
+    int32_t fieldHeight = height + 2 * spread;
+    size_t size = size_t(fieldWidth) * size_t(fieldHeight);
+
+    // Squared distances to the nearest inside and outside pixel.
+    std::vector<float> outside(size, Infinity);
+    std::vector<float> inside(size, 0.0f);
+
+    for(int32_t y = 0; y < height; y++) {
+      const uint8_t* row = bitmap + std::ptrdiff_t(y) * pitch;
+
+      for(int32_t x = 0; x < width; x++) {
+        if(row[x] < 128) {
+          continue;
+        }
+
+        size_t index = size_t(y + spread) * size_t(fieldWidth) +
+            size_t(x + spread);
+        outside[index] = 0.0f;
+        inside[index] = Infinity;
+      }
+    }
+
+    Transform2D(outside, fieldWidth, fieldHeight);
+    Transform2D(inside, fieldWidth, fieldHeight);
+
+    std::vector<uint8_t> field(size);
+
+    for(size_t i = 0; i < size; i++) {
+      // Pixel centers are half a pixel away from the outline.
+      float distance = outside[i] > 0.0f ?
+          -(std::sqrt(outside[i]) - 0.5f) : std::sqrt(inside[i]) - 0.5f;
+
+      float value = 0.5f + distance / float(2 * spread);
+      field[i] = uint8_t(std::lround(
+          std::min(std::max(value, 0.0f), 1.0f) * 255.0f));
+    }
+
+    return field;
+  }
+
+}
@@ -0,0 +1,125 @@
+/*
+ * neonGX - FontPack.cpp
+ *
+ * Copyright (c) 2016, cynecx
+ *
+ * This file is part of neonGX and is distributed under a modified
+ * BSD 3-Clause License. See LICENSE.txt for details.
+ *
+ */
+
+#include <neonGX/Core/Text/FontPack.hpp>
+#include <cstdio>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace neonGX {
+
+  optional<FontPackView> ParseFontPack(gsl::span<const uint8_t> data) {
+    FontPackView view;
+
+    size_t size = size_t(data.size());
+    if(size < sizeof(FontPackHeader)) {
+      return nullopt;
+    }
+
+    std::memcpy(&view.Header, data.data(), sizeof(FontPackHeader));
+
+    const FontPackHeader& header = view.Header;
+    if(header.Magic != FontPackMagic || header.Version != FontPackVersion) {
+      return nullopt;
+    }
+
+    size_t glyphBytes = size_t(header.GlyphCount) * sizeof(FontPackGlyph);
+    size_t kerningBytes = size_t(header.KerningCount) *
+        sizeof(FontPackKerning);
+    size_t pixelBytes = size_t(header.AtlasWidth) *
+        size_t(header.AtlasHeight);
+
+    if(size != sizeof(FontPackHeader) + glyphBytes + kerningBytes +
+        pixelBytes) {
+      return nullopt;
+    }
+
+    // The header size keeps the records 4 byte aligned within the file.
+    const uint8_t* cursor = data.data() + sizeof(FontPackHeader);
+
+    view.Glyphs = {reinterpret_cast<const FontPackGlyph*>(cursor),
+        std::ptrdiff_t(header.GlyphCount)};
+    cursor += glyphBytes;
+
+    view.Kernings = {reinterpret_cast<const FontPackKerning*>(cursor),
+        std::ptrdiff_t(header.KerningCount)};
+    cursor += kerningBytes;
+
+    view.AtlasPixels = {cursor, std::ptrdiff_t(pixelBytes)};
+
+    for(const FontPackGlyph& glyph : view.Glyphs) {
+      if(uint32_t(glyph.X) + glyph.Width > header.AtlasWidth ||
+         uint32_t(glyph.Y) + glyph.Height > header.AtlasHeight) {
+        return nullopt;
+      }
+    }
+
+    return view;
+  }
+
+  bool WriteFontPack(const std::string& filename,
+                     const FontPackHeader& header,
+                     const std::vector<FontPackGlyph>& glyphs,
+                     const std::vector<FontPackKerning>& kernings,
+                     const std::vector<uint8_t>& atlasPixels) {
+    if(header.GlyphCount != glyphs.size() ||
+       header.KerningCount != kernings.size() ||
+       size_t(header.AtlasWidth) * header.AtlasHeight != atlasPixels.size()) {
+      return false;
+    }
+
+    FILE* file = std::fopen(filename.c_str(), "wb");
+    if(!file) {
+      return false;
+    }
+
+    bool result =
+        std::fwrite(&header, sizeof(header), 1, file) == 1 &&
+        std::fwrite(glyphs.data(), sizeof(FontPackGlyph), glyphs.size(),
+            file) == glyphs.size() &&
+        std::fwrite(kernings.data(), sizeof(FontPackKerning),
+            kernings.size(), file) == kernings.size() &&
+        std::fwrite(atlasPixels.data(), 1, atlasPixels.size(), file) ==
+            atlasPixels.size();
+
+    return std::fclose(file) == 0 && result;
+  }
+
+  MappedFile::MappedFile(const std::string& filename) {
+    int fd = open(filename.c_str(), O_RDONLY);
+    if(fd < 0) {
+      return;
+    }
+
+    struct stat info;
+    if(fstat(fd, &info) == 0 && info.st_size > 0) {
+      void* data = mmap(nullptr, size_t(info.st_size), PROT_READ,
+          MAP_PRIVATE, fd, 0);
+
+      if(data != MAP_FAILED) {
+        m_Data = static_cast<const uint8_t*>(data);
+        m_Size = size_t(info.st_size);
+      }
+    }
+
+    close(fd);
+  }
+
+  MappedFile::~MappedFile() {
+    if(m_Data) {
+      munmap(const_cast<uint8_t*>(m_Data), m_Size);
+    }
+  }
+
+}
@@ -10,117 +10,333 @@
 
 #include <neonGX/Core/Text/FontTextureManager.hpp>
 #include <neonGX/Core/Math/Primitives.hpp>
+#include <neonGX/Core/Text/FontPack.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
 #include <iostream>
+#include <iterator>
 #include <exception>
+#include <mutex>
 
 namespace neonGX {
 
-  namespace {
-    struct FTFontFaceRAII {
-      FT_Face fontFace = nullptr;
+#ifdef NEONGX_USE_FREETYPE
+  // Staging pages a worker packs glyphs into, its regions refer to the
+  // index of their staging page.
+  struct StagedGlyphPages {
+    int32_t PageSize;
+    std::vector<GlyphAtlas::StagingPage> Pages;
 
-      explicit FTFontFaceRAII(FT_Face _faceFont) : fontFace(_faceFont) {}
+    optional<GlyphAtlasRegion> Insert(int32_t width, int32_t height,
+                                      const uint8_t* pixels, int32_t pitch) {
+      optional<GlyphAtlasRegion> region;
+      if(!Pages.empty()) {
+        region = Pages.back().Insert(width, height, pixels, pitch);
+      }
 
-      ~FTFontFaceRAII() {
-        if(fontFace) {
-          return;
-        }
+      if(!region) {
+        Pages.emplace_back(PageSize);
+        region = Pages.back().Insert(width, height, pixels, pitch);
+      }
 
-        FT_Done_Face(fontFace);
+      if(region) {
+        region->Page = Pages.size() - 1;
       }
+      return region;
+    }
+  };
+
+  struct PendingFontLoad {
+    std::string Filename;
+    std::string FontName;
+    size_t Height;
+    FontRenderMode Mode;
+    std::function<void(bool)> OnLoaded;
+
+    std::promise<bool> Promise;
+    std::shared_future<bool> Future;
+
+    std::atomic<size_t> RemainingJobs{0};
+    std::atomic<bool> Failed{false};
+    // Set by the job finishing last, once it packed the glyphs of all jobs.
+    std::atomic<bool> Packed{false};
+
+    std::mutex Mutex;
+    std::vector<RasterizedGlyph> Glyphs;
+
+    // The glyphs of Font live on Staged, their pages are only remapped to
+    // atlas pages by ProcessPendingLoads.
+    FontData Font;
+    StagedGlyphPages Staged;
+  };
+#endif
+
+  // Glyphs only land in the CPU side of the atlas here, the pages are
+  // uploaded once they are used for rendering.
+  template<typename Atlas>
+  static FontCharacterData InsertGlyph(Atlas& atlas,
+                                       const RasterizedGlyph& glyph,
+                                       int32_t ascender) {
+    FontCharacterData character{
+        0,
+        0,
+        {{0.0f, 0.0f, 0.0f, 0.0f}},
+        FSize{0.0f, 0.0f},
+        glyph.BearingX,
+        glyph.BearingY,
+        glyph.AdvanceX,
+        ascender
     };
 
-    struct PixelStoreiRAII {
-      GLenum Mode;
-      GLint OldValue = 0;
+    if(glyph.Width > 0 && glyph.Height > 0) {
+      auto region = atlas.Insert(glyph.Width, glyph.Height,
+          glyph.Pixels.data(), glyph.Width);
+      assert(region && "Glyph exceeds the atlas page size.");
 
-      explicit PixelStoreiRAII(GLenum mode, GLint newVal) : Mode(mode) {
-        glGetIntegerv(mode, &OldValue);
-        assert(OldValue != GL_INVALID_ENUM);
-        if(OldValue == newVal) {
-          OldValue = GL_INVALID_ENUM;
-          return;
-        }
-        glPixelStorei(Mode, newVal);
+      if(region) {
+        character.Page = region->Page;
+        character.Generation = region->Generation;
+        character.UVs = region->UVs;
+        character.Size = FSize{float(glyph.Width), float(glyph.Height)};
       }
+    }
 
-      ~PixelStoreiRAII() {
-        if(OldValue == GL_INVALID_ENUM) {
-          return;
-        }
-        glPixelStorei(Mode, OldValue);
-      }
-    };
+    return character;
   }
 
-  FontTextureManager::FontTextureManager(webgl_context_handle glHandle)
-      : m_GlHandle(glHandle) {
+#ifdef NEONGX_USE_FREETYPE
+  // Packs the glyphs of all jobs of the load, on the worker finishing it
+  // last. Its face stays with the font for the lazily rasterized glyphs.
+  static void PackGlyphs(PendingFontLoad& load,
+      std::unique_ptr<FT_LibraryRec_, FTLibraryDeleter> library,
+      std::unique_ptr<FT_FaceRec_, FTFaceDeleter> face) {
+    FontData& fontData = load.Font;
+    fontData.FontSource = load.Filename;
+    fontData.Mode = load.Mode;
+    fontData.Height = load.Height;
+    fontData.Ascender = int32_t(face->size->metrics.ascender >> 6);
+    fontData.Library = std::move(library);
+    fontData.Face = std::move(face);
+
+    // Tall glyphs first pack tighter, the codepoint keeps the atlas layout
+    // independent of the job scheduling.
+    std::sort(load.Glyphs.begin(), load.Glyphs.end(),
+        [] (const RasterizedGlyph& lhs, const RasterizedGlyph& rhs) {
+          if(lhs.Height != rhs.Height) {
+            return lhs.Height > rhs.Height;
+          }
+          return lhs.Codepoint < rhs.Codepoint;
+        });
+
+    for(const RasterizedGlyph& glyph : load.Glyphs) {
+      fontData.CharTextures[glyph.Codepoint] = InsertGlyph(load.Staged,
+          glyph, fontData.Ascender);
+    }
+
+    load.Glyphs.clear();
+  }
+#endif
+
+  FontTextureManager::FontTextureManager(webgl_context_handle glHandle,
+                                         size_t maxAtlasPages)
+      : m_GlHandle(glHandle),
+        m_GlyphAtlas(glHandle, GlyphAtlas::DefaultPageSize, maxAtlasPages) {
+#ifdef NEONGX_USE_FREETYPE
     int result = FT_Init_FreeType(&m_ft2Instance);
     assert(result == 0);
     ((void)result);
+#endif
   }
 
-  FontTextureManager::~FontTextureManager() = default;
+  FontTextureManager::~FontTextureManager() {
+    // Joins the workers before anything they report to goes away.
+    m_WorkerPool.reset();
+    m_PendingLoads.clear();
+
+    // The faces have to go before the library owning them.
+    m_LoadedFontMap.clear();
+#ifdef NEONGX_USE_FREETYPE
+    FT_Done_FreeType(m_ft2Instance);
+#endif
+  }
 
+#ifdef NEONGX_USE_FREETYPE
   bool FontTextureManager::LoadFont(const std::string& filename,
                                     const std::string& fontName,
-                                    size_t height) {
+                                    size_t height, FontRenderMode mode) {
     if(IsValidKey(fontName)) {
       return false;
     }
 
-    WebGLContextRAII switchCtx(m_GlHandle);
-    PixelStoreiRAII pixelUnpack(GL_UNPACK_ALIGNMENT, 1);
-
-    FT_Face fontface = nullptr;
-    if(FT_New_Face(m_ft2Instance, filename.c_str(), 0, &fontface)) {
+    FT_Face fontface = OpenFontFace(m_ft2Instance, filename, height);
+    if(!fontface) {
       return false;
     }
 
-    FTFontFaceRAII fontfaceRAII(fontface);
-    FT_Set_Pixel_Sizes(fontface, 0, height);
-
     FontData fontData;
+    fontData.Face.reset(fontface);
     fontData.FontSource = filename;
+    fontData.Mode = mode;
+    fontData.Height = height;
+    fontData.Ascender = int32_t(fontface->size->metrics.ascender >> 6);
 
-    int32_t MaxDescent = 0;
+    m_LoadedFontMap.emplace(fontName, std::move(fontData));
+
+    return true;
+  }
 
-    for(uint8_t currChar = 0; currChar < 128; currChar++) {
-      if(FT_Load_Char(fontface, currChar, FT_LOAD_RENDER)) {
-        continue;
+  std::shared_future<bool> FontTextureManager::LoadFontAsync(
+      const std::string& filename, const std::string& fontName,
+      size_t height, FontRenderMode mode,
+      std::function<void(bool)> onLoaded) {
+    auto load = std::make_shared<PendingFontLoad>();
+    load->Filename = filename;
+    load->FontName = fontName;
+    load->Height = height;
+    load->Mode = mode;
+    load->OnLoaded = std::move(onLoaded);
+    load->Future = load->Promise.get_future().share();
+
+    bool pending = std::any_of(m_PendingLoads.begin(), m_PendingLoads.end(),
+        [&fontName] (const auto& other) {
+          return other->FontName == fontName;
+        });
+
+    if(pending || IsValidKey(fontName)) {
+      load->Promise.set_value(false);
+      if(load->OnLoaded) {
+        load->OnLoaded(false);
       }
+      return load->Future;
+    }
 
-      MaxDescent = std::max<int32_t>(fontface->glyph->bitmap_top, MaxDescent);
+    if(!m_WorkerPool) {
+      m_WorkerPool = std::make_unique<WorkerPool>();
+    }
 
-      GLTexture texture(m_GlHandle, nullopt, GL_LUMINANCE, GL_UNSIGNED_BYTE);
+    // Printable ASCII is rasterized up front, everything else lazily.
+    std::vector<char32_t> codepoints;
+    for(char32_t codepoint = 0x20; codepoint < 0x7F; codepoint++) {
+      codepoints.push_back(codepoint);
+    }
 
-      texture.EnableWrapClamp();
-      texture.SetMagFilter(ScaleMode::Linear);
-      texture.SetMinFilter(ScaleMode::Linear);
+    size_t jobs = std::min(m_WorkerPool->GetThreadCount(), codepoints.size());
+    load->RemainingJobs = jobs;
+    load->Staged.PageSize = m_GlyphAtlas.GetPageSize();
+    m_PendingLoads.push_back(load);
 
-      bool hasSize = fontface->glyph->bitmap.width > 0 ||
-                     fontface->glyph->bitmap.rows > 0;
-      if(hasSize) {
-        int dataLen = fontface->glyph->bitmap.width *
-                      fontface->glyph->bitmap.rows;
-        texture.UploadData({fontface->glyph->bitmap.buffer, dataLen},
-            FSize{float(fontface->glyph->bitmap.width),
-                  float(fontface->glyph->bitmap.rows)});
-      }
+    for(size_t job = 0; job < jobs; job++) {
+      size_t begin = codepoints.size() * job / jobs;
+      size_t end = codepoints.size() * (job + 1) / jobs;
+
+      std::vector<char32_t> slice(codepoints.begin() + std::ptrdiff_t(begin),
+          codepoints.begin() + std::ptrdiff_t(end));
+
+      // FreeType libraries and faces must not be shared between threads,
+      // every job opens its own.
+      m_WorkerPool->Submit([load, slice = std::move(slice)] {
+        std::vector<RasterizedGlyph> glyphs;
+
+        std::unique_ptr<FT_LibraryRec_, FTLibraryDeleter> library;
+        std::unique_ptr<FT_FaceRec_, FTFaceDeleter> face;
+
+        FT_Library ftLibrary = nullptr;
+        if(!FT_Init_FreeType(&ftLibrary)) {
+          library.reset(ftLibrary);
+          face.reset(OpenFontFace(ftLibrary, load->Filename, load->Height));
+        }
+
+        if(face) {
+          glyphs.reserve(slice.size());
+          for(char32_t codepoint : slice) {
+            glyphs.push_back(RasterizeGlyph(face.get(), codepoint,
+                load->Mode));
+          }
+        } else {
+          load->Failed = true;
+        }
+
+        {
+          std::lock_guard<std::mutex> lock(load->Mutex);
+          std::move(glyphs.begin(), glyphs.end(),
+              std::back_inserter(load->Glyphs));
+        }
+
+        // Every other job already handed its glyphs over.
+        if(load->RemainingJobs.fetch_sub(1) == 1) {
+          if(!load->Failed) {
+            std::lock_guard<std::mutex> lock(load->Mutex);
+            PackGlyphs(*load, std::move(library), std::move(face));
+          }
+          load->Packed = true;
+        }
+      });
+    }
+
+    return load->Future;
+  }
+
+#endif
+
+  bool FontTextureManager::LoadFontPack(const std::string& filename,
+                                        const std::string& fontName) {
+    if(IsValidKey(fontName)) {
+      return false;
+    }
+
+    MappedFile file(filename);
+    if(!file.IsValid()) {
+      return false;
+    }
+
+    auto pack = ParseFontPack(file.GetData());
+    if(!pack) {
+      return false;
+    }
+
+    const FontPackHeader& header = pack->Header;
+
+    // The cooked atlas is uploaded as is, as a page of its own.
+    auto page = m_GlyphAtlas.AddPinnedPage(int32_t(header.AtlasWidth),
+        int32_t(header.AtlasHeight), pack->AtlasPixels.data());
+    if(!page) {
+      return false;
+    }
 
+    FontData fontData;
+    fontData.FontSource = filename;
+    fontData.Mode = header.Mode == uint32_t(FontRenderMode::DistanceField) ?
+        FontRenderMode::DistanceField : FontRenderMode::Bitmap;
+    fontData.Height = header.Height;
+    fontData.Ascender = header.Ascender;
+
+    float pageSize = float(m_GlyphAtlas.GetPageSize());
+
+    for(const FontPackGlyph& glyph : pack->Glyphs) {
       FontCharacterData character{
-          {std::move(texture)},
-          fontface->glyph->bitmap_left,
-          fontface->glyph->bitmap_top,
-          int32_t(fontface->glyph->advance.x),
-          0
+          *page,
+          0,
+          {{
+              float(glyph.X) / pageSize,
+              float(glyph.Y) / pageSize,
+              float(glyph.X + glyph.Width) / pageSize,
+              float(glyph.Y + glyph.Height) / pageSize
+          }},
+          FSize{float(glyph.Width), float(glyph.Height)},
+          glyph.BearingX,
+          glyph.BearingY,
+          glyph.AdvanceX,
+          header.Ascender
       };
 
-      fontData.CharTextures.emplace(char16_t(currChar), std::move(character));
+      fontData.CharTextures.emplace(char32_t(glyph.Codepoint), character);
     }
 
-    for(auto& it : fontData.CharTextures) {
-      it.second.DescentY = MaxDescent;
+    for(const FontPackKerning& kerning : pack->Kernings) {
+      fontData.Kerning.emplace(
+          KerningKey(char32_t(kerning.Left), char32_t(kerning.Right)),
+          kerning.AdvanceX);
     }
 
     m_LoadedFontMap.emplace(fontName, std::move(fontData));
@@ -128,8 +344,114 @@ namespace neonGX {
     return true;
   }
 
-  optional<const FontData*> FontTextureManager::GetFontData(
-      const std::string& fontName) const {
+  int32_t FontTextureManager::GetKerning(const FontData& fontData,
+                                         char32_t left, char32_t right) {
+    if(!fontData.Kerning.empty()) {
+      auto it = fontData.Kerning.find(KerningKey(left, right));
+      return it != fontData.Kerning.end() ? it->second : 0;
+    }
+
+#ifdef NEONGX_USE_FREETYPE
+    FT_Face face = fontData.Face.get();
+    if(face && FT_HAS_KERNING(face)) {
+      FT_Vector delta;
+      if(!FT_Get_Kerning(face, FT_Get_Char_Index(face, FT_ULong(left)),
+          FT_Get_Char_Index(face, FT_ULong(right)), FT_KERNING_DEFAULT,
+          &delta)) {
+        return int32_t(delta.x);
+      }
+    }
+#endif
+
+    return 0;
+  }
+
+  void FontTextureManager::ProcessPendingLoads() {
+#ifdef NEONGX_USE_FREETYPE
+    auto finished = std::stable_partition(m_PendingLoads.begin(),
+        m_PendingLoads.end(), [] (const auto& load) {
+          return !load->Packed.load();
+        });
+
+    std::vector<std::shared_ptr<PendingFontLoad>> loads(
+        std::make_move_iterator(finished),
+        std::make_move_iterator(m_PendingLoads.end()));
+    m_PendingLoads.erase(finished, m_PendingLoads.end());
+
+    // The workers rasterized and packed the glyphs already, only their
+    // finished pages are handed to the atlas here.
+    std::vector<size_t> atlasPages;
+
+    for(auto& load : loads) {
+      bool loaded = !load->Failed && !IsValidKey(load->FontName);
+
+      if(loaded) {
+        atlasPages.clear();
+        for(GlyphAtlas::StagingPage& page : load->Staged.Pages) {
+          atlasPages.push_back(m_GlyphAtlas.AddPage(std::move(page)));
+        }
+
+        FontData& fontData = load->Font;
+        for(auto& entry : fontData.CharTextures) {
+          FontCharacterData& character = entry.second;
+          if(character.Size.IsZero()) {
+            continue;
+          }
+
+          character.Page = atlasPages[character.Page];
+          character.Generation = m_GlyphAtlas.GetGeneration(character.Page);
+        }
+
+        m_LoadedFontMap.emplace(load->FontName, std::move(fontData));
+      }
+
+      load->Promise.set_value(loaded);
+      if(load->OnLoaded) {
+        load->OnLoaded(loaded);
+      }
+    }
+#endif
+  }
+
+  const FontCharacterData& FontTextureManager::GetCharacter(
+      FontData& fontData, char32_t codepoint) {
+    auto it = fontData.CharTextures.find(codepoint);
+    if(it != fontData.CharTextures.end()) {
+      FontCharacterData& character = it->second;
+
+      if(character.Size.IsZero()) {
+        return character;
+      }
+
+      if(m_GlyphAtlas.IsValid(character.Page, character.Generation)) {
+        m_GlyphAtlas.Touch(character.Page);
+        return character;
+      }
+    }
+
+#ifdef NEONGX_USE_FREETYPE
+    if(fontData.Face) {
+      auto glyph = RasterizeGlyph(fontData.Face.get(), codepoint,
+          fontData.Mode);
+
+      return fontData.CharTextures[codepoint] = InsertGlyph(m_GlyphAtlas,
+          glyph, fontData.Ascender);
+    }
+#endif
+
+    // Cooked fonts only know the glyphs they were cooked with.
+    auto fallback = fontData.CharTextures.find(U'?');
+    if(fallback != fontData.CharTextures.end()) {
+      return fontData.CharTextures[codepoint] = fallback->second;
+    }
+
+    RasterizedGlyph empty{codepoint, 0, 0, 0, 0, 0, {}};
+    return fontData.CharTextures[codepoint] = InsertGlyph(m_GlyphAtlas,
+        empty, fontData.Ascender);
+  }
+
+  optional<FontData*> FontTextureManager::GetFontData(
+      const std::string& fontName) {
     auto it = m_LoadedFontMap.find(fontName);
     if(it == m_LoadedFontMap.end()) {
       return nullopt;
@@ -143,6 +465,7 @@ namespace neonGX {
 
   void FontTextureManager::Clear() {
     m_LoadedFontMap.clear();
+    m_GlyphAtlas.Clear();
   }
 
 }
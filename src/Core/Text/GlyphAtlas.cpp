@@ -0,0 +1,267 @@
+/*
+ * neonGX - GlyphAtlas.cpp
+ *
+ * Copyright (c) 2016, cynecx
+ *
+ * This file is part of neonGX and is distributed under a modified
+ * BSD 3-Clause License. See LICENSE.txt for details.
+ *
+ */
+
+#include <neonGX/Core/Text/GlyphAtlas.hpp>
+#include <neonGX/Core/Textures/BaseTexture.hpp>
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+namespace neonGX {
+
+  GlyphAtlas::Page::Page(int32_t size)
+      : Packer(size, size), Pixels(size_t(size) * size_t(size), 0),
+        DirtyBegin(0), DirtyEnd(size) {
+  }
+
+  GlyphAtlas::Page::Page(StagingPage&& staging)
+      : Packer(std::move(staging.m_Packer)),
+        Pixels(std::move(staging.m_Pixels)),
+        DirtyBegin(0), DirtyEnd(staging.m_Size) {
+  }
+
+  GlyphAtlas::StagingPage::StagingPage(int32_t size)
+      : m_Size(size), m_Packer(size, size),
+        m_Pixels(size_t(size) * size_t(size), 0) {
+  }
+
+  optional<GlyphAtlasRegion> GlyphAtlas::StagingPage::Insert(int32_t width,
+      int32_t height, const uint8_t* pixels, int32_t pitch) {
+    assert(width > 0 && height > 0);
+
+    auto position = m_Packer.Insert(width + 2 * Padding,
+        height + 2 * Padding);
+    if(!position) {
+      return nullopt;
+    }
+
+    return CopyGlyph(m_Pixels, m_Size, *position, width, height, pixels,
+        pitch);
+  }
+
+  GlyphAtlasRegion GlyphAtlas::CopyGlyph(std::vector<uint8_t>& pagePixels,
+                                         int32_t pageSize,
+                                         const NPoint& position,
+                                         int32_t width, int32_t height,
+                                         const uint8_t* pixels,
+                                         int32_t pitch) {
+    int32_t x = position.x + Padding;
+    int32_t y = position.y + Padding;
+
+    for(int32_t row = 0; row < height; row++) {
+      std::memcpy(pagePixels.data() + size_t(y + row) * size_t(pageSize) + x,
+          pixels + row * pitch, size_t(width));
+    }
+
+    float size = float(pageSize);
+
+    return GlyphAtlasRegion{
+        0,
+        0,
+        NRectangle{{x, y}, {width, height}},
+        {{
+            float(x) / size,
+            float(y) / size,
+            float(x + width) / size,
+            float(y + height) / size
+        }}
+    };
+  }
+
+  GlyphAtlas::Page* GlyphAtlas::FindEvictablePage() {
+    auto lru = std::min_element(m_Pages.begin(), m_Pages.end(),
+        [] (const Page& lhs, const Page& rhs) {
+          if(lhs.Pinned != rhs.Pinned) {
+            return rhs.Pinned;
+          }
+          return lhs.LastUsedFrame < rhs.LastUsedFrame;
+        });
+
+    if(lru == m_Pages.end() || lru->Pinned ||
+       lru->LastUsedFrame + m_FramesInFlight > m_Frame) {
+      return nullptr;
+    }
+
+    return &*lru;
+  }
+
+  GlyphAtlas::GlyphAtlas(webgl_context_handle glHandle, int32_t pageSize,
+                         size_t maxPages)
+      : m_GLHandle(glHandle), m_PageSize(pageSize),
+        m_MaxPages(std::max<size_t>(maxPages, 1)) {
+    // Full rows are uploaded, keeps them aligned to GL_UNPACK_ALIGNMENT.
+    assert(m_PageSize > 0 && m_PageSize % 4 == 0);
+  }
+
+  GlyphAtlas::~GlyphAtlas() = default;
+
+  optional<GlyphAtlasRegion> GlyphAtlas::Insert(int32_t width, int32_t height,
+                                                const uint8_t* pixels,
+                                                int32_t pitch) {
+    assert(width > 0 && height > 0);
+
+    int32_t paddedWidth = width + 2 * Padding;
+    int32_t paddedHeight = height + 2 * Padding;
+
+    if(paddedWidth > m_PageSize || paddedHeight > m_PageSize) {
+      return nullopt;
+    }
+
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    size_t pageIndex = 0;
+    optional<NPoint> position;
+
+    for(; pageIndex < m_Pages.size(); pageIndex++) {
+      if(m_Pages[pageIndex].Pinned) {
+        continue;
+      }
+
+      position = m_Pages[pageIndex].Packer.Insert(paddedWidth, paddedHeight);
+      if(position) {
+        break;
+      }
+    }
+
+    if(!position && m_Pages.size() - m_PinnedPages >= m_MaxPages) {
+      if(Page* lru = FindEvictablePage()) {
+        lru->Packer.Clear();
+        std::fill(lru->Pixels.begin(), lru->Pixels.end(), 0);
+        lru->DirtyBegin = 0;
+        lru->DirtyEnd = m_PageSize;
+        lru->Generation++;
+        m_EvictedPages++;
+
+        pageIndex = size_t(lru - m_Pages.data());
+        position = lru->Packer.Insert(paddedWidth, paddedHeight);
+        assert(position);
+      }
+    }
+
+    if(!position) {
+      m_Pages.emplace_back(m_PageSize);
+      pageIndex = m_Pages.size() - 1;
+      position = m_Pages.back().Packer.Insert(paddedWidth, paddedHeight);
+      assert(position);
+    }
+
+    Page& page = m_Pages[pageIndex];
+    page.LastUsedFrame = m_Frame;
+
+    GlyphAtlasRegion region = CopyGlyph(page.Pixels, m_PageSize, *position,
+        width, height, pixels, pitch);
+    region.Page = pageIndex;
+    region.Generation = page.Generation;
+
+    const NRectangle& rect = region.Rect;
+    page.DirtyBegin = std::min(page.DirtyBegin, rect.point.y);
+    page.DirtyEnd = std::max(page.DirtyEnd, rect.point.y + rect.size.height);
+
+    return region;
+  }
+
+  size_t GlyphAtlas::AddPage(StagingPage&& staging) {
+    assert(staging.m_Size == m_PageSize);
+
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    if(m_Pages.size() - m_PinnedPages >= m_MaxPages) {
+      if(Page* lru = FindEvictablePage()) {
+        lru->Packer = std::move(staging.m_Packer);
+        lru->Pixels = std::move(staging.m_Pixels);
+        lru->DirtyBegin = 0;
+        lru->DirtyEnd = m_PageSize;
+        lru->LastUsedFrame = m_Frame;
+        lru->Generation++;
+        m_EvictedPages++;
+
+        return size_t(lru - m_Pages.data());
+      }
+    }
+
+    m_Pages.emplace_back(std::move(staging));
+    m_Pages.back().LastUsedFrame = m_Frame;
+
+    return m_Pages.size() - 1;
+  }
+
+  optional<size_t> GlyphAtlas::AddPinnedPage(int32_t width, int32_t height,
+                                             const uint8_t* pixels) {
+    if(width <= 0 || height <= 0 || width > m_PageSize ||
+       height > m_PageSize) {
+      return nullopt;
+    }
+
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    m_Pages.emplace_back(m_PageSize);
+    m_PinnedPages++;
+
+    Page& page = m_Pages.back();
+    page.Pinned = true;
+    page.LastUsedFrame = m_Frame;
+
+    for(int32_t row = 0; row < height; row++) {
+      std::memcpy(page.Pixels.data() + size_t(row) * m_PageSize,
+          pixels + size_t(row) * size_t(width), size_t(width));
+    }
+
+    return m_Pages.size() - 1;
+  }
+
+  void GlyphAtlas::Upload() {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    for(Page& page : m_Pages) {
+      if(page.DirtyBegin >= page.DirtyEnd) {
+        continue;
+      }
+
+      if(!page.Texture) {
+        page.Texture = std::make_unique<GLTexture>(m_GLHandle, nullopt,
+            GL_LUMINANCE, GL_UNSIGNED_BYTE);
+
+        page.Texture->EnableWrapClamp();
+        page.Texture->SetMagFilter(ScaleMode::Linear);
+        page.Texture->SetMinFilter(ScaleMode::Linear);
+
+        page.Texture->UploadData(page.Pixels,
+            FSize{float(m_PageSize), float(m_PageSize)});
+      } else {
+        size_t offset = size_t(page.DirtyBegin) * size_t(m_PageSize);
+        size_t size = size_t(page.DirtyEnd - page.DirtyBegin) *
+            size_t(m_PageSize);
+
+        page.Texture->UploadSubData({page.Pixels.data() + offset,
+            std::ptrdiff_t(size)},
+            NRectangle{{0, page.DirtyBegin},
+                       {m_PageSize, page.DirtyEnd - page.DirtyBegin}});
+      }
+
+      page.DirtyBegin = m_PageSize;
+      page.DirtyEnd = 0;
+    }
+  }
+
+  const GLTexture* GlyphAtlas::GetPageTexture(size_t page) const {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    assert(page < m_Pages.size());
+    return m_Pages[page].Texture.get();
+  }
+
+  void GlyphAtlas::Clear() {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    m_Pages.clear();
+    m_PinnedPages = 0;
+  }
+
+}
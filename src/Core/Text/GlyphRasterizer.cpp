@@ -0,0 +1,81 @@
+/*
+ * neonGX - GlyphRasterizer.cpp
+ *
+ * Copyright (c) 2016, cynecx
+ *
+ * This file is part of neonGX and is distributed under a modified
+ * BSD 3-Clause License. See LICENSE.txt for details.
+ *
+ */
+
+#include <neonGX/Core/Text/GlyphRasterizer.hpp>
+
+#ifdef NEONGX_USE_FREETYPE
+
+#include <neonGX/Core/Text/DistanceField.hpp>
+#include <cstring>
+
+namespace neonGX {
+
+  FT_Face OpenFontFace(FT_Library library, const std::string& filename,
+                       size_t height) {
+    FT_Face face = nullptr;
+    if(FT_New_Face(library, filename.c_str(), 0, &face)) {
+      return nullptr;
+    }
+
+    if(FT_Set_Pixel_Sizes(face, 0, FT_UInt(height))) {
+      FT_Done_Face(face);
+      return nullptr;
+    }
+
+    return face;
+  }
+
+  RasterizedGlyph RasterizeGlyph(FT_Face face, char32_t codepoint,
+                                 FontRenderMode mode) {
+    RasterizedGlyph result{codepoint, 0, 0, 0, 0, 0, {}};
+
+    if(FT_Load_Char(face, FT_ULong(codepoint), FT_LOAD_RENDER)) {
+      return result;
+    }
+
+    const FT_GlyphSlot glyph = face->glyph;
+    const FT_Bitmap& bitmap = glyph->bitmap;
+
+    result.BearingX = glyph->bitmap_left;
+    result.BearingY = glyph->bitmap_top;
+    result.AdvanceX = int32_t(glyph->advance.x);
+
+    int32_t width = int32_t(bitmap.width);
+    int32_t height = int32_t(bitmap.rows);
+    if(width <= 0 || height <= 0) {
+      return result;
+    }
+
+    if(mode == FontRenderMode::DistanceField) {
+      const int32_t spread = DistanceFieldSpread;
+      result.Pixels = GenerateDistanceField(bitmap.buffer, width, height,
+          bitmap.pitch, spread);
+      result.Width = width + 2 * spread;
+      result.Height = height + 2 * spread;
+      result.BearingX -= spread;
+      result.BearingY += spread;
+      return result;
+    }
+
+    result.Width = width;
+    result.Height = height;
+    result.Pixels.resize(size_t(width) * size_t(height));
+
+    for(int32_t y = 0; y < height; y++) {
+      std::memcpy(result.Pixels.data() + size_t(y) * size_t(width),
+          bitmap.buffer + std::ptrdiff_t(y) * bitmap.pitch, size_t(width));
+    }
+
+    return result;
+  }
+
+}
+
+#endif // NEONGX_USE_FREETYPE
@@ -0,0 +1,108 @@
+/*
+ * neonGX - SkylinePacker.cpp
+ *
+ * Copyright (c) 2016, cynecx
+ *
+ * This file is part of neonGX and is distributed under a modified
+ * BSD 3-Clause License. See LICENSE.txt for details.
+ *
+ */
+
+#include <neonGX/Core/Text/SkylinePacker.hpp>
+#include <cassert>
+#include <limits>
+
+namespace neonGX {
+
+  SkylinePacker::SkylinePacker(int32_t width, int32_t height)
+      : m_Width(width), m_Height(height) {
+    Clear();
+  }
+
+  void SkylinePacker::Clear() {
+    m_Skyline.clear();
+    m_Skyline.push_back(SkylineNode{0, 0, m_Width});
+  }
+
+  optional<int32_t> SkylinePacker::Fit(size_t index, int32_t width,
+                                       int32_t height) const {
+    int32_t x = m_Skyline[index].X;
+    if(x + width > m_Width) {
+      return nullopt;
+    }
+
+    // The rectangle rests on the highest node it spans.
+    int32_t y = 0;
+    int32_t remaining = width;
+
+    for(size_t i = index; remaining > 0; i++) {
+      assert(i < m_Skyline.size());
+
+      y = std::max(y, m_Skyline[i].Y);
+      if(y + height > m_Height) {
+        return nullopt;
+      }
+
+      remaining -= m_Skyline[i].Width;
+    }
+
+    return y;
+  }
+
+  optional<NPoint> SkylinePacker::Insert(int32_t width, int32_t height) {
+    size_t bestIndex = m_Skyline.size();
+    int32_t bestBottom = std::numeric_limits<int32_t>::max();
+    int32_t bestY = 0;
+
+    for(size_t i = 0; i < m_Skyline.size(); i++) {
+      auto y = Fit(i, width, height);
+      if(y && *y + height < bestBottom) {
+        bestIndex = i;
+        bestBottom = *y + height;
+        bestY = *y;
+      }
+    }
+
+    if(bestIndex == m_Skyline.size()) {
+      return nullopt;
+    }
+
+    NPoint position{m_Skyline[bestIndex].X, bestY};
+
+    m_Skyline.insert(m_Skyline.begin() + bestIndex,
+        SkylineNode{position.x, bestBottom, width});
+
+    // Cut the nodes now covered by the new one.
+    for(size_t i = bestIndex + 1; i < m_Skyline.size();) {
+      const SkylineNode& previous = m_Skyline[i - 1];
+      SkylineNode& node = m_Skyline[i];
+
+      int32_t previousEnd = previous.X + previous.Width;
+      if(node.X >= previousEnd) {
+        break;
+      }
+
+      int32_t shrink = previousEnd - node.X;
+      node.X += shrink;
+      node.Width -= shrink;
+
+      if(node.Width > 0) {
+        break;
+      }
+
+      m_Skyline.erase(m_Skyline.begin() + i);
+    }
+
+    for(size_t i = 1; i < m_Skyline.size();) {
+      if(m_Skyline[i - 1].Y == m_Skyline[i].Y) {
+        m_Skyline[i - 1].Width += m_Skyline[i].Width;
+        m_Skyline.erase(m_Skyline.begin() + i);
+      } else {
+        i++;
+      }
+    }
+
+    return position;
+  }
+
+}
@@ -12,106 +12,210 @@
 #include <neonGX/Core/Renderer/OpenGL/GLRenderer.hpp>
 #include <neonGX/Core/Text/TextRenderer.hpp>
 #include <neonGX/Core/Math/Primitives.hpp>
+#include <algorithm>
+#include <limits>
 
 namespace neonGX {
 
   Text::Text(const std::string& text, const std::string& fontName) :
-      m_Text(text), m_FontName(fontName) {
+      m_Text(text), m_Codepoints(DecodeUTF8(text)), m_FontName(fontName) {
   }
 
   Text::~Text() = default;
 
-  FSize Text::GetSize(GLRenderer* renderer) const {
-    assert(renderer != nullptr);
+  float Text::GetFontScale(const FontData& fontData) const {
+    if(m_FontSize <= 0.0f || fontData.Height == 0) {
+      return 1.0f;
+    }
+    return m_FontSize / float(fontData.Height);
+  }
 
-    auto optFontData = renderer->GetFontTextureManager()->GetFontData(
-        m_FontName);
-    if(!optFontData) {
-      return {0.0f, 0.0f};
+  void Text::SetText(const std::string& text) {
+    if(text == m_Text) {
+      return;
     }
 
-    const FontData* fontData = optFontData.value();
+    std::u32string codepoints = DecodeUTF8(text);
+
+    size_t common = std::min(codepoints.size(), m_Codepoints.size());
+    auto mismatch = std::mismatch(codepoints.begin(),
+        codepoints.begin() + std::ptrdiff_t(common), m_Codepoints.begin());
+    size_t prefix = size_t(mismatch.first - codepoints.begin());
 
-    FSize retSize;
+    m_LayoutValidCount = std::min(m_LayoutValidCount, prefix);
 
-    for(size_t i = 0; i < m_Text.size(); i++) {
-      char16_t characterToRender = char16_t(m_Text[i]);
+    m_Text = text;
+    m_Codepoints = std::move(codepoints);
+    m_IsDirty = true;
+    ContentChanged();
+  }
 
-      if(characterToRender >= 128) {
-        characterToRender = 0;
+  void Text::UpdateLayout(FontTextureManager& fontManager,
+                          FontData& fontData) const {
+    float scale = GetFontScale(fontData);
+
+    if(m_LayoutFont != &fontData || m_LayoutScale != scale) {
+      m_LayoutFont = &fontData;
+      m_LayoutScale = scale;
+      m_LayoutValidCount = 0;
+    }
+
+    size_t count = m_Codepoints.size();
+    if(m_LayoutValidCount == count && m_Layout.size() == count) {
+      return;
+    }
+
+    m_Layout.resize(count);
+
+    size_t first = std::min(m_LayoutValidCount, count);
+    float currentX = 0.0f;
+    if(first > 0) {
+      currentX = m_Layout[first - 1].PenX + m_Layout[first - 1].Advance;
+    }
+
+    for(size_t i = first; i < count; i++) {
+      if(i > 0) {
+        int32_t kerning = fontManager.GetKerning(fontData, m_Codepoints[i - 1],
+            m_Codepoints[i]);
+        currentX += float(kerning >> 6) * scale;
       }
 
-      auto it = fontData->CharTextures.find(characterToRender);
-      const auto& glyphInfo = it->second;
-      FSize glyphSize = glyphInfo.Texture.GetSize();
+      const auto& glyphInfo = fontManager.GetCharacter(fontData,
+          m_Codepoints[i]);
+      FSize glyphSize = glyphInfo.Size;
+
+      TextLayoutGlyph& glyph = m_Layout[i];
+      glyph.Codepoint = m_Codepoints[i];
+      glyph.PenX = currentX;
+      glyph.Advance = float(glyphInfo.AdvanceX >> 6) * scale;
+      glyph.Visible = !glyphSize.IsZero();
+      glyph.Page = glyphInfo.Page;
+      glyph.Generation = glyphInfo.Generation;
+      glyph.UVs = glyphInfo.UVs;
+
+      float x0 = currentX + float(glyphInfo.BearingX) * scale;
+      float y0 = float(glyphInfo.DescentY - glyphInfo.BearingY) * scale;
+      glyph.Quad = {{
+          x0, y0,
+          x0 + glyphSize.width * scale, y0 + glyphSize.height * scale
+      }};
+
+      currentX += glyph.Advance;
+    }
 
-      retSize.width += glyphInfo.AdvanceX >> 6;
-      retSize.height = std::max(retSize.height, glyphSize.height);
+    m_LayoutValidCount = count;
+
+    m_LayoutSize = FSize{currentX, 0.0f};
+    for(const TextLayoutGlyph& glyph : m_Layout) {
+      m_LayoutSize.height = std::max(m_LayoutSize.height,
+          glyph.Quad[3] - glyph.Quad[1]);
     }
+  }
 
-    return retSize;
+  FSize Text::GetSize(GLRenderer* renderer) const {
+    assert(renderer != nullptr);
+
+    auto fontManager = renderer->GetFontTextureManager();
+    auto optFontData = fontManager->GetFontData(m_FontName);
+    if(!optFontData) {
+      return {0.0f, 0.0f};
+    }
+
+    UpdateLayout(*fontManager, *optFontData.value());
+
+    return m_LayoutSize;
   }
 
   void Text::CalculateVertices(GLRenderer* renderer) {
     assert(renderer != nullptr);
 
-    auto optFontData = renderer->m_FontTextureManager->GetFontData(m_FontName);
+    auto& fontManager = renderer->m_FontTextureManager;
+    auto optFontData = fontManager->GetFontData(m_FontName);
     if(!optFontData) {
+      // Stays dirty until the font gets loaded.
+      m_GlyphQuads.clear();
+      m_IsDirty = true;
       return;
     }
 
-    size_t vertexCount = 8 * m_Text.size();
-    m_VertexData.resize(vertexCount);
-
-    const FontData* fontData = optFontData.value();
-
-    float currentX = 0;
+    FontData* fontData = optFontData.value();
+    UpdateLayout(*fontManager, *fontData);
 
-    for(size_t i = 0; i < m_Text.size(); i++) {
-      float* vertexData = m_VertexData.data() + i * 8;
-      char16_t characterToRender = char16_t(m_Text[i]);
+    m_FontMode = fontData->Mode;
+    m_GlyphQuads.clear();
 
-      if(characterToRender >= 128) {
-        characterToRender = 0;
+    for(const TextLayoutGlyph& glyph : m_Layout) {
+      if(!glyph.Visible) {
+        continue;
       }
 
-      auto it = fontData->CharTextures.find(characterToRender);
-      const auto& glyphInfo = it->second;
+      const auto& quad = glyph.Quad;
+      const float corners[8] = {
+          quad[0], quad[1],
+          quad[2], quad[1],
+          quad[2], quad[3],
+          quad[0], quad[3]
+      };
 
-      FSize glyphSize = glyphInfo.Texture.GetSize();
+      TextGlyphQuad glyphQuad;
+      m_WorldTransform.Apply(corners, glyphQuad.Positions.data(), 4);
 
-      if(!glyphSize.IsZero()) {
-        float w1 = currentX + float(glyphInfo.BearingX);
-        float w0 = w1 + glyphSize.width;
+      glyphQuad.UVs = glyph.UVs;
+      glyphQuad.Page = glyph.Page;
+      glyphQuad.Generation = glyph.Generation;
+      glyphQuad.Codepoint = glyph.Codepoint;
 
-        float h1 = glyphInfo.DescentY - glyphInfo.BearingY;
-        float h0 = glyphSize.height + h1;
+      m_GlyphQuads.push_back(glyphQuad);
+    }
 
-        auto result = m_WorldTransform * Matrix<3, 1, float>{w1, h1, 1.0f};
-        auto accessor = result.GetColumnAccessor(0);
-        vertexData[0] = accessor[0];
-        vertexData[1] = accessor[1];
+    float minX = std::numeric_limits<float>::max();
+    float minY = std::numeric_limits<float>::max();
+    float maxX = std::numeric_limits<float>::lowest();
+    float maxY = std::numeric_limits<float>::lowest();
+
+    for(const TextGlyphQuad& glyphQuad : m_GlyphQuads) {
+      for(size_t i = 0; i < glyphQuad.Positions.size(); i += 2) {
+        minX = std::min(minX, glyphQuad.Positions[i]);
+        maxX = std::max(maxX, glyphQuad.Positions[i]);
+        minY = std::min(minY, glyphQuad.Positions[i + 1]);
+        maxY = std::max(maxY, glyphQuad.Positions[i + 1]);
+      }
+    }
+
+    if(m_GlyphQuads.empty()) {
+      m_WorldBounds = { {0, 0}, {0, 0} };
+    } else {
+      m_WorldBounds = RoundOutBounds(minX, minY, maxX, maxY);
+    }
+    m_WorldBoundsValid = true;
+  }
 
-        result = m_WorldTransform * Matrix<3, 1, float>{w0, h1, 1.0f};
-        auto accessor2 = result.GetColumnAccessor(0);
-        vertexData[2] = accessor2[0];
-        vertexData[3] = accessor2[1];
+  bool Text::HitTestLocal(const FPoint& point) {
+    if(m_Layout.empty() || m_LayoutValidCount != m_Layout.size()) {
+      return false;
+    }
 
-        result = m_WorldTransform * Matrix<3, 1, float>{w0, h0, 1.0f};
-        auto accessor3 = result.GetColumnAccessor(0);
-        vertexData[4] = accessor3[0];
-        vertexData[5] = accessor3[1];
+    const TextLayoutGlyph& last = m_Layout.back();
+    float minY = std::numeric_limits<float>::max();
+    float maxY = std::numeric_limits<float>::lowest();
 
-        result = m_WorldTransform * Matrix<3, 1, float>{w1, h0, 1.0f};
-        auto accessor4 = result.GetColumnAccessor(0);
-        vertexData[6] = accessor4[0];
-        vertexData[7] = accessor4[1];
-      } else {
-        m_ExcludeSet.emplace(i);
+    for(const TextLayoutGlyph& glyph : m_Layout) {
+      if(!glyph.Visible) {
+        continue;
       }
+      minY = std::min(minY, glyph.Quad[1]);
+      maxY = std::max(maxY, glyph.Quad[3]);
+    }
+
+    return point.x >= 0.0f && point.x < last.PenX + last.Advance &&
+           point.y >= minY && point.y < maxY;
+  }
 
-      currentX += (glyphInfo.AdvanceX >> 6);
+  NRectangle Text::GetBounds() {
+    if(!m_WorldBoundsValid) {
+      return { {0, 0}, {0, 0} };
     }
+    return m_WorldBounds;
   }
 
   void Text::RenderWebGL(GLRenderer* renderer) {
@@ -122,11 +226,13 @@ namespace neonGX {
       CalculateVertices(renderer);
     }
 
-    if(m_VertexData.empty()) {
+    if(m_GlyphQuads.empty() || renderer->CullObject(*this)) {
       return;
     }
 
-    renderer->SetObjectRenderer(ObjectRendererType::Text)->Render(this);
+    renderer->SubmitRenderCommand(ObjectRendererType::Text, this,
+        static_cast<uint8_t>(m_FontMode),
+        static_cast<uint32_t>(m_GlyphQuads.front().Page));
   }
 
 }
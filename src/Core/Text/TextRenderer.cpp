@@ -12,6 +12,7 @@
 #include <neonGX/Core/Text/Text.hpp>
 #include <neonGX/Core/Renderer/OpenGL/GLRenderer.hpp>
 #include <algorithm>
+#include <cstring>
 
 namespace neonGX {
 
@@ -36,24 +37,28 @@ namespace neonGX {
 
     WebGLContextRAII switchCtx(m_GLHandle);
 
-    m_Vertices.resize(BatchSize * 4 * VertexByteSize);
+    m_CompactVertices = m_Renderer->m_Settings.BatchVertexFormat ==
+        VertexFormat::Compact;
+    m_VertexByteSize = m_CompactVertices ?
+        CompactVertexByteSize : VertexByteSize;
+
+    m_Vertices.resize(BatchSize * 4 * m_VertexByteSize);
     CreateIndicesForQuads(BatchSize, m_Indices);
 
     m_Renderer->m_ShaderManager->InitializeFontTextureShader();
+    m_Renderer->m_ShaderManager->InitializeSDFFontTextureShader(
+        m_Renderer->m_Extensions.HasStandardDerivatives());
 
     gsl::span<const uint8_t> indices(
         reinterpret_cast<const uint8_t*>(m_Indices.data()),
         m_Indices.size() * sizeof(uint16_t));
 
-    gsl::span<const uint8_t> vertices(
-        reinterpret_cast<const uint8_t*>(m_Vertices.data()),
-        m_Vertices.size() * sizeof(uint8_t));
-
     m_IndexBuffer = std::shared_ptr<GLBuffer>(
         GLBuffer::CreateIndexBuffer(m_GLHandle, indices, GL_STATIC_DRAW));
 
     m_VertexBuffer = std::shared_ptr<GLBuffer>(
-        GLBuffer::CreateVertexBuffer(m_GLHandle, vertices, GL_DYNAMIC_DRAW));
+        GLBuffer::CreateStreamingVertexBuffer(
+            m_GLHandle, StreamedBatches * m_Vertices.size()));
   }
 
   TextRenderer::~TextRenderer() = default;
@@ -61,181 +66,240 @@ namespace neonGX {
   void TextRenderer::Start() {
     WebGLContextRAII switchCtx(m_GLHandle);
 
-    auto& textureShader = m_Renderer->m_ShaderManager->UseFontTextureShader();
+    m_Renderer->m_ShaderManager->UseFontTextureShader();
     m_VertexBuffer->Bind();
     m_IndexBuffer->Bind();
 
     m_Renderer->m_ShaderManager->ActivateShaderAttributes();
 
+    m_Renderer->m_StateCache->ActiveTexture(0);
+  }
+
+  FontTextureShader& TextRenderer::UseShader(FontRenderMode mode) {
+    auto& shaderManager = m_Renderer->m_ShaderManager;
+
+    if(mode == FontRenderMode::DistanceField) {
+      return shaderManager->UseSDFFontTextureShader();
+    }
+    return shaderManager->UseFontTextureShader();
+  }
+
+  void TextRenderer::SetVertexAttributes(FontTextureShader& textureShader,
+                                         size_t baseOffset) {
     glVertexAttribPointer(
         textureShader.m_shaderAttributes["aVertexPosition"].Location,
-        2, GL_FLOAT, GL_FALSE, VertexByteSize,
-        reinterpret_cast<const void*>(0));
+        2, GL_FLOAT, GL_FALSE, GLsizei(m_VertexByteSize),
+        reinterpret_cast<const void*>(baseOffset));
+
+    if(m_CompactVertices) {
+      glVertexAttribPointer(
+          textureShader.m_shaderAttributes["aTextureCoord"].Location,
+          2, GL_UNSIGNED_SHORT, GL_TRUE, CompactVertexByteSize,
+          reinterpret_cast<const void*>(baseOffset + 8));
+      glVertexAttribPointer(
+          textureShader.m_shaderAttributes["aColor"].Location,
+          3, GL_UNSIGNED_BYTE, GL_TRUE, CompactVertexByteSize,
+          reinterpret_cast<const void*>(baseOffset + 12));
+      return;
+    }
+
     glVertexAttribPointer(
         textureShader.m_shaderAttributes["aTextureCoord"].Location,
         2, GL_FLOAT, GL_FALSE, VertexByteSize,
-        reinterpret_cast<const void*>(2 * sizeof(float)));
+        reinterpret_cast<const void*>(baseOffset + 2 * sizeof(float)));
     glVertexAttribPointer(
         textureShader.m_shaderAttributes["aColor"].Location,
         3, GL_FLOAT, GL_FALSE, VertexByteSize,
-        reinterpret_cast<const void*>(4 * sizeof(float)));
-
-    glActiveTexture(GL_TEXTURE0);
+        reinterpret_cast<const void*>(baseOffset + 4 * sizeof(float)));
   }
 
   void TextRenderer::Stop() {
     Flush();
   }
 
+  void TextRenderer::ValidateGlyphs(FontTextureManager& fontManager,
+                                    Text& text) {
+    auto& glyphAtlas = fontManager.GetGlyphAtlas();
+    FontData* fontData = nullptr;
+
+    for(TextGlyphQuad& glyph : text.m_GlyphQuads) {
+      if(glyphAtlas.IsValid(glyph.Page, glyph.Generation)) {
+        glyphAtlas.Touch(glyph.Page);
+        continue;
+      }
+
+      if(fontData == nullptr) {
+        auto optFontData = fontManager.GetFontData(text.m_FontName);
+        assert(optFontData);
+        fontData = optFontData.value();
+      }
+
+      const auto& glyphInfo = fontManager.GetCharacter(*fontData,
+          glyph.Codepoint);
+      glyph.Page = glyphInfo.Page;
+      glyph.Generation = glyphInfo.Generation;
+      glyph.UVs = glyphInfo.UVs;
+    }
+  }
+
+  TextRun TextRenderer::GetTextRun(const Text& text) {
+    return TextRun{
+        text.m_GlyphQuads.data(), text.m_GlyphQuads.size(),
+        text.m_FontMode, text.m_Color
+    };
+  }
+
   void TextRenderer::Flush() {
     m_CurrentBatchCount = 0;
 
-    if(m_TextObjects.empty()) {
+    if(m_Runs.empty()) {
       return;
     }
 
     WebGLContextRAII switchCtx(m_GLHandle);
 
-    float* floatView = reinterpret_cast<float*>(m_Vertices.data());
+    auto& glyphAtlas = m_Renderer->m_FontTextureManager->GetGlyphAtlas();
 
-    size_t bufferIndex = 0;
-    size_t vertexIndex = 0;
-    size_t sumTextureToRender = 0;
-
-    for(auto textObj : m_TextObjects) {
-      float red = float(textObj->m_Color.r) / 255;
-      float green = float(textObj->m_Color.g) / 255;
-      float blue = float(textObj->m_Color.b) / 255;
+    uint8_t* output = m_Vertices.data();
 
-      for(size_t i = 0; i < textObj->m_Text.size(); i++) {
-        if(textObj->m_ExcludeSet.find(i) != textObj->m_ExcludeSet.end()) {
-          vertexIndex += 8;
-          continue;
+    size_t sumTextureToRender = 0;
+    m_Batches.clear();
+
+    for(const TextRun& run : m_Runs) {
+      const auto& color = run.Color;
+      const FontRenderMode mode = run.Mode;
+
+      float rgb[3] = {
+          float(color.r) / 255, float(color.g) / 255, float(color.b) / 255
+      };
+      uint8_t rgba[4] = { color.r, color.g, color.b, 0xFF };
+
+      for(size_t i = 0; i < run.GlyphCount; i++) {
+        const TextGlyphQuad& glyph = run.Glyphs[i];
+
+        // Glyphs only break a batch when they live on another atlas page
+        // or need the other shader.
+        if(m_Batches.empty() || m_Batches.back().Page != glyph.Page ||
+           m_Batches.back().Mode != mode) {
+          m_Batches.push_back(TextBatch{
+              glyph.Page, mode, sumTextureToRender, 0
+          });
         }
 
+        m_Batches.back().Size++;
         sumTextureToRender++;
 
-        floatView[bufferIndex++] = textObj->m_VertexData[vertexIndex++];
-        floatView[bufferIndex++] = textObj->m_VertexData[vertexIndex++];
-        floatView[bufferIndex++] = 0;
-        floatView[bufferIndex++] = 0;
-        floatView[bufferIndex++] = red;
-        floatView[bufferIndex++] = green;
-        floatView[bufferIndex++] = blue;
-
-        floatView[bufferIndex++] = textObj->m_VertexData[vertexIndex++];
-        floatView[bufferIndex++] = textObj->m_VertexData[vertexIndex++];
-        floatView[bufferIndex++] = 1;
-        floatView[bufferIndex++] = 0;
-        floatView[bufferIndex++] = red;
-        floatView[bufferIndex++] = green;
-        floatView[bufferIndex++] = blue;
-
-        floatView[bufferIndex++] = textObj->m_VertexData[vertexIndex++];
-        floatView[bufferIndex++] = textObj->m_VertexData[vertexIndex++];
-        floatView[bufferIndex++] = 1;
-        floatView[bufferIndex++] = 1;
-        floatView[bufferIndex++] = red;
-        floatView[bufferIndex++] = green;
-        floatView[bufferIndex++] = blue;
-
-        floatView[bufferIndex++] = textObj->m_VertexData[vertexIndex++];
-        floatView[bufferIndex++] = textObj->m_VertexData[vertexIndex++];
-        floatView[bufferIndex++] = 0;
-        floatView[bufferIndex++] = 1;
-        floatView[bufferIndex++] = red;
-        floatView[bufferIndex++] = green;
-        floatView[bufferIndex++] = blue;
+        const auto& uvs = glyph.UVs;
+        const float corners[8] = {
+            uvs[0], uvs[1], uvs[2], uvs[1], uvs[2], uvs[3], uvs[0], uvs[3]
+        };
+
+        for(size_t corner = 0; corner < 8; corner += 2) {
+          std::memcpy(output, glyph.Positions.data() + corner,
+              2 * sizeof(float));
+          output += 2 * sizeof(float);
+
+          if(m_CompactVertices) {
+            uint16_t uv[2] = {
+                uint16_t(corners[corner] * 65535),
+                uint16_t(corners[corner + 1] * 65535)
+            };
+            std::memcpy(output, uv, sizeof(uv));
+            std::memcpy(output + sizeof(uv), rgba, sizeof(rgba));
+            output += sizeof(uv) + sizeof(rgba);
+          } else {
+            std::memcpy(output, corners + corner, 2 * sizeof(float));
+            std::memcpy(output + 2 * sizeof(float), rgb, sizeof(rgb));
+            output += 2 * sizeof(float) + sizeof(rgb);
+          }
+        }
       }
     }
 
-    size_t batchDataSize = sumTextureToRender * VertexByteSize * 4;
-    gsl::span<const uint8_t> tmpSpan(m_Vertices.data(), batchDataSize);
-
-    m_VertexBuffer->UploadSubData(tmpSpan);
+    glyphAtlas.Upload();
 
-    auto renderBatch = [] (webgl_context_handle glHandle,
-                           const GLTexture* texture,
-                           size_t size, size_t startIndex) {
-      if(size == 0 || texture == nullptr) {
-        return;
-      }
-      texture->Bind(nullopt);
-      glDrawElements(GL_TRIANGLES, GLsizei(size * 6), GL_UNSIGNED_SHORT,
-          reinterpret_cast<const void*>(startIndex * 6 * 2));
-    };
-
-#ifdef NEONGX_USE_EMSCRIPTEN
-    glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
-#else
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-#endif
+    size_t batchDataSize = sumTextureToRender * m_VertexByteSize * 4;
+    gsl::span<const uint8_t> tmpSpan(m_Vertices.data(), batchDataSize);
 
-    auto& shader = m_Renderer->m_ShaderManager->UseFontTextureShader();
-    shader.SetProjectionMatrix(
-        m_Renderer->m_RenderTarget->m_ProjectionMatrix);
+    size_t baseOffset = m_VertexBuffer->StreamData(tmpSpan);
 
-    size_t batchSize = 0;
-    size_t startBatch = 0;
+    auto& stats = m_Renderer->m_Stats;
+    stats.Flushes++;
 
-    const GLTexture* currentBaseTexture = nullptr;
-    const GLTexture* nextBaseTexture = nullptr;
+    optional<FontRenderMode> currentMode;
 
-    size_t index = 0;
+    for(const TextBatch& batch : m_Batches) {
+      const GLTexture* texture = glyphAtlas.GetPageTexture(batch.Page);
+      if(texture == nullptr) {
+        continue;
+      }
 
-    for(auto to : m_TextObjects) {
-      auto optFontData = m_Renderer->m_FontTextureManager->GetFontData(
-          to->m_FontName);
-      assert(optFontData);
+      if(currentMode != batch.Mode) {
+        currentMode = batch.Mode;
 
-      const FontData* fontData = optFontData.value();
+        // Both shaders read the same vertex layout, but attribute locations
+        // are assigned per program.
+        auto& shader = UseShader(batch.Mode);
+        m_Renderer->m_ShaderManager->ActivateShaderAttributes();
+        SetVertexAttributes(shader, baseOffset);
+        shader.SetProjectionMatrix(
+            m_Renderer->m_CurrentRenderTarget->m_ProjectionMatrix);
 
-      for(size_t i = 0; i < to->m_Text.size(); i++) {
-        if(to->m_ExcludeSet.find(i) != to->m_ExcludeSet.end()) {
-          continue;
+        // The distance field shader outputs premultiplied colors.
+#ifdef NEONGX_USE_EMSCRIPTEN
+        m_Renderer->m_StateCache->BlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+#else
+        if(batch.Mode == FontRenderMode::DistanceField) {
+          m_Renderer->m_StateCache->BlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+        } else {
+          m_Renderer->m_StateCache->BlendFunc(GL_SRC_ALPHA,
+              GL_ONE_MINUS_SRC_ALPHA);
         }
+#endif
+      }
 
-        auto it = fontData->CharTextures.find(char16_t(to->m_Text[i]));
-        const auto& glyphInfo = it->second;
-
-        nextBaseTexture = &glyphInfo.Texture;
-
-        if(currentBaseTexture != nextBaseTexture) {
-          renderBatch(m_GLHandle, currentBaseTexture, batchSize, startBatch);
-
-          startBatch = index;
-          batchSize = 0;
-          currentBaseTexture = nextBaseTexture;
-        }
+      stats.DrawCalls++;
 
-        ++index;
-        ++batchSize;
-      }
+      texture->Bind(nullopt);
+      glDrawElements(GL_TRIANGLES, GLsizei(batch.Size * 6), GL_UNSIGNED_SHORT,
+          reinterpret_cast<const void*>(batch.Start * 6 * 2));
     }
 
-    renderBatch(m_GLHandle, currentBaseTexture, batchSize, startBatch);
-
-    m_TextObjects.clear();
+    m_Runs.clear();
   }
 
   void TextRenderer::Render(DisplayObject* object) {
-    assert(m_CurrentBatchCount <= BatchSize);
-
-    if(m_CurrentBatchCount == BatchSize) {
-      Flush();
-    }
-
     auto* textObj = dynamic_cast<Text*>(object);
     assert(textObj != nullptr);
 
-    size_t addTextures = textObj->GetText().size();
-    if(m_CurrentBatchCount + addTextures > BatchSize) {
+    ValidateGlyphs(*m_Renderer->m_FontTextureManager, *textObj);
+    RenderRun(GetTextRun(*textObj));
+  }
+
+  void TextRenderer::RenderRun(const TextRun& run) {
+    assert(m_CurrentBatchCount <= BatchSize);
+
+    // Runs are split where the batch runs full, a text may well have more
+    // glyphs than a single batch holds.
+    TextRun remaining = run;
+    while(m_CurrentBatchCount + remaining.GlyphCount > BatchSize) {
+      size_t count = BatchSize - m_CurrentBatchCount;
+
+      if(count > 0) {
+        m_Runs.push_back(TextRun{
+            remaining.Glyphs, count, remaining.Mode, remaining.Color
+        });
+        remaining.Glyphs += count;
+        remaining.GlyphCount -= count;
+      }
+
+      m_CurrentBatchCount = BatchSize;
       Flush();
     }
 
     // Every character is a single texture
-    m_CurrentBatchCount += textObj->GetText().size();
-    m_TextObjects.push_back(textObj);
+    m_CurrentBatchCount += remaining.GlyphCount;
+    m_Runs.push_back(remaining);
   }
 
 }
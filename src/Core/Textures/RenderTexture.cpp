@@ -0,0 +1,44 @@
+/*
+ * neonGX - RenderTexture.cpp
+ *
+ * Copyright (c) 2016, cynecx
+ *
+ * This file is part of neonGX and is distributed under a modified
+ * BSD 3-Clause License. See LICENSE.txt for details.
+ *
+ */
+
+#include <neonGX/Core/Textures/RenderTexture.hpp>
+
+namespace neonGX {
+
+  static std::shared_ptr<BaseTexture> CreateBaseTexture(const FSize& size,
+      float resolution, ScaleMode scaleMode) {
+    auto baseTexture = std::make_shared<BaseTexture>();
+    baseTexture->m_Size = size;
+    baseTexture->m_Resolution = resolution;
+    baseTexture->m_ScaleMode = scaleMode;
+    return baseTexture;
+  }
+
+  RenderTexture::RenderTexture(webgl_context_handle glHandle,
+                               const FSize& size, float resolution,
+                               ScaleMode scaleMode)
+      : Texture(CreateBaseTexture(size, resolution, scaleMode), nullopt) {
+    m_RenderTarget = std::make_unique<GLRenderTarget>(
+        glHandle, size, resolution, scaleMode, false);
+
+    // Sprites look the GL texture up by context, the framebuffer texture
+    // takes the place of the uploaded image.
+    GetBaseTexture()->m_GlTextureMap[glHandle] =
+        m_RenderTarget->m_FrameBuffer->m_Texture;
+  }
+
+  void RenderTexture::Resize(const FSize& size) {
+    m_RenderTarget->Resize(size);
+
+    GetBaseTexture()->m_Size = size;
+    SetFrame(FRectangle{ {0, 0}, size });
+  }
+
+}
@@ -0,0 +1,126 @@
+/*
+ * neonGX - WorkerPool.cpp
+ *
+ * Copyright (c) 2016, cynecx
+ *
+ * This file is part of neonGX and is distributed under a modified
+ * BSD 3-Clause License. See LICENSE.txt for details.
+ *
+ */
+
+#include <neonGX/Core/Threading/WorkerPool.hpp>
+#include <algorithm>
+#include <cassert>
+
+#if !defined(NEONGX_USE_EMSCRIPTEN) || defined(__EMSCRIPTEN_PTHREADS__)
+#define NEONGX_WORKERPOOL_THREADS
+#endif
+
+namespace neonGX {
+
+  WorkerPool::WorkerPool(size_t threadCount) {
+#ifdef NEONGX_WORKERPOOL_THREADS
+    if(threadCount == 0) {
+      size_t hardwareThreads = std::thread::hardware_concurrency();
+      threadCount = std::max<size_t>(hardwareThreads, 2) - 1;
+    }
+
+    m_Threads.reserve(threadCount);
+    for(size_t i = 0; i < threadCount; i++) {
+      m_Threads.emplace_back(&WorkerPool::WorkerLoop, this);
+    }
+#else
+    ((void)threadCount);
+#endif
+  }
+
+  WorkerPool::~WorkerPool() {
+    {
+      std::lock_guard<std::mutex> lock(m_Mutex);
+      m_Stopping = true;
+    }
+    m_JobAvailable.notify_all();
+
+    for(auto& thread : m_Threads) {
+      thread.join();
+    }
+  }
+
+  void WorkerPool::Submit(std::function<void()> job) {
+    if(m_Threads.empty()) {
+      job();
+      return;
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(m_Mutex);
+      m_Jobs.push_back(std::move(job));
+    }
+    m_JobAvailable.notify_one();
+  }
+
+  void WorkerPool::ParallelFor(size_t count, size_t grain,
+      const std::function<void(size_t, size_t)>& body) {
+    assert(grain > 0);
+
+    size_t grains = (count + grain - 1) / grain;
+    size_t ranges = std::min(grains, m_Threads.size() + 1);
+
+    if(ranges <= 1) {
+      if(count > 0) {
+        body(0, count);
+      }
+      return;
+    }
+
+    size_t rangeSize = (grains + ranges - 1) / ranges * grain;
+    ranges = (count + rangeSize - 1) / rangeSize;
+
+    std::mutex mutex;
+    std::condition_variable done;
+    size_t pending = ranges - 1;
+
+    // The first range is kept for the calling thread.
+    for(size_t begin = rangeSize; begin < count; begin += rangeSize) {
+      size_t end = std::min(begin + rangeSize, count);
+
+      Submit([&, begin, end] {
+        body(begin, end);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if(--pending == 0) {
+          done.notify_one();
+        }
+      });
+    }
+
+    body(0, std::min(rangeSize, count));
+
+    std::unique_lock<std::mutex> lock(mutex);
+    done.wait(lock, [&] { return pending == 0; });
+  }
+
+  void WorkerPool::WorkerLoop() {
+    for(;;) {
+      std::function<void()> job;
+
+      {
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        m_JobAvailable.wait(lock, [this] {
+          return m_Stopping || !m_Jobs.empty();
+        });
+
+        // Queued jobs still run, so nobody waits on a dropped job.
+        if(m_Jobs.empty()) {
+          return;
+        }
+
+        job = std::move(m_Jobs.front());
+        m_Jobs.pop_front();
+      }
+
+      job();
+    }
+  }
+
+}
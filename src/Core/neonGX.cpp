@@ -10,6 +10,7 @@
 
 #include <neonGX/Core/neonGX.hpp>
 #include <neonGX/Core/Renderer/OpenGL/GLContext.hpp>
+#include <neonGX/Core/Renderer/OpenGL/GLRenderer.hpp>
 
 #include <cassert>
 
@@ -37,7 +38,7 @@ namespace neonGX {
     neonGXMainLoop();
   }
 
-  void RunMainLoop(webgl_context_handle glHandle,
+  void RunMainLoop(GLRenderer& renderer,
                    std::function<void()> loopCallback) {
     assert(neonGXInitialized);
     assert(!neonGXMainLoop);
@@ -49,6 +50,8 @@ namespace neonGX {
 #endif
 
 #ifndef NEONGX_USE_EMSCRIPTEN
+    webgl_context_handle glHandle = renderer.webgl_handle;
+
     while (true) {
       glfwPollEvents();
 
@@ -57,7 +60,20 @@ namespace neonGX {
       }
 
       ProxyMainLoop();
-      glfwSwapBuffers(glHandle);
+
+      // Render threads present the frames they draw.
+      if(renderer.PresentsOnRenderThread()) {
+        continue;
+      }
+
+      if(renderer.HasNewFrame()) {
+        glfwSwapBuffers(glHandle);
+      } else {
+        // Skipped frames keep the last one on screen. Without a swap
+        // nothing waits for vsync, idle scenes wait for input or the next
+        // frame interval instead of spinning.
+        glfwWaitEventsTimeout(1.0 / 60.0);
+      }
     }
 #endif
   }
@@ -134,6 +134,10 @@ namespace {
       return renderer->webgl_handle;
     }
 
+    neonGX::GLRenderer& GetRenderer() {
+      return *renderer;
+    }
+
     void InitializeServerConnection() {
       using namespace asio;
 
@@ -235,8 +239,13 @@ namespace {
     void InitializeFontsAndTextObjects() {
       using namespace neonGX;
 
+#ifdef NEONGX_USE_FREETYPE
       bool result = fontManager->LoadFont(
           "./assets/fonts/mh.ttf", "MinimalHard42", 55);
+#else
+      bool result = fontManager->LoadFontPack(
+          "./assets/fonts/mh.ngxfont", "MinimalHard42");
+#endif
       assert(result);
       ((void)result);
 
@@ -321,23 +330,25 @@ namespace {
           assert("What da fuck is dis shit..." && false);
       }
 
-      auto& colorRefText = BannerText->GetColorRef();
+      neonGX::ColorRGB textColor;
 
       switch(CurrentColorScheme) {
         case ColorScheme::Orange:
-          colorRefText = *neonGX::ColorRGB::FromHex("#ffbb03");
+          textColor = *neonGX::ColorRGB::FromHex("#ffbb03");
           break;
         case ColorScheme::Violet:
-          colorRefText = *neonGX::ColorRGB::FromHex("#d33c79");
+          textColor = *neonGX::ColorRGB::FromHex("#d33c79");
           break;
         case ColorScheme::Yellow:
-          colorRefText = *neonGX::ColorRGB::FromHex("#f9df00");
+          textColor = *neonGX::ColorRGB::FromHex("#f9df00");
           break;
         case ColorScheme::Blue:
-          colorRefText = *neonGX::ColorRGB::FromHex("#009cff");
+          textColor = *neonGX::ColorRGB::FromHex("#009cff");
           break;
       }
 
+      BannerText->SetColor(textColor);
+
       SpriteMap["field"]->SetTexture(TextureMap["field_" + color]);
       SpriteMap["ball"]->SetTexture(TextureMap["ball_" + color]);
       SpriteMap["player1"]->SetTexture(TextureMap["paddle_" + color]);
@@ -618,7 +629,7 @@ int main() {
 
   gameInstance = std::make_unique<NeonPong>();
 
-  neonGX::RunMainLoop(gameInstance->GetGLHandle(), GameLoop);
+  neonGX::RunMainLoop(gameInstance->GetRenderer(), GameLoop);
 
   return 0;
 }
@@ -0,0 +1,143 @@
+/*
+ * neonGX - AffineBench.cpp
+ *
+ * Copyright (c) 2016, cynecx
+ *
+ * This file is part of neonGX and is distributed under a modified
+ * BSD 3-Clause License. See LICENSE.txt for details.
+ *
+ */
+
+#include "Bench.hpp"
+#include <neonGX/Core/Math/Affine2D.hpp>
+#include <neonGX/Core/Math/Matrix.hpp>
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace neonGX {
+
+  // Enough transforms and points to defeat constant folding while staying
+  // in the L1 cache.
+  static constexpr size_t TransformCount = 1024;
+  static constexpr size_t Iterations = 2000;
+
+  static bool NearlyEqual(const Affine2D& affine, Matrix3& matrix) {
+    Affine2D converted = Affine2D::FromMatrix3(matrix);
+    const float lhs[] = { affine.A, affine.B, affine.Tx,
+                          affine.C, affine.D, affine.Ty };
+    const float rhs[] = { converted.A, converted.B, converted.Tx,
+                          converted.C, converted.D, converted.Ty };
+
+    for(size_t i = 0; i < 6; i++) {
+      float tolerance = 1e-3f * std::max(1.0f, std::abs(lhs[i]));
+      if(std::abs(lhs[i] - rhs[i]) > tolerance) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  bool RunAffineBench() {
+    std::mt19937 random(TransformCount);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+
+    std::vector<Affine2D> affines(TransformCount);
+    std::vector<Matrix3> matrices(TransformCount);
+    std::vector<float> points(TransformCount * 2);
+
+    for(size_t i = 0; i < TransformCount; i++) {
+      affines[i] = Affine2D::Translation(unit(random) * 100.0f,
+                                         unit(random) * 100.0f) *
+          Affine2D::Rotation(unit(random) * 3.14f) *
+          Affine2D::Scaling(1.5f + unit(random), 1.5f + unit(random));
+      matrices[i] = affines[i].ToMatrix3();
+      points[i * 2] = unit(random) * 500.0f;
+      points[i * 2 + 1] = unit(random) * 500.0f;
+    }
+
+    std::vector<Affine2D> affineResults(TransformCount);
+    std::vector<Matrix3> matrixResults(TransformCount);
+    std::vector<float> affinePoints(TransformCount * 2);
+    std::vector<float> matrixPoints(TransformCount * 2);
+
+    // Parent * local, as done by every world transform update.
+    double affineCompose = BenchMeasure(Iterations, [&] {
+      for(size_t i = 0; i < TransformCount; i++) {
+        affineResults[i] = affines[i] * affines[TransformCount - 1 - i];
+      }
+      BenchKeep(affineResults.data());
+    });
+    double matrixCompose = BenchMeasure(Iterations, [&] {
+      for(size_t i = 0; i < TransformCount; i++) {
+        matrixResults[i] = matrices[i] * matrices[TransformCount - 1 - i];
+      }
+      BenchKeep(matrixResults.data());
+    });
+
+    bool composeMatches = NearlyEqual(affineResults[1], matrixResults[1]);
+
+    double affineInverse = BenchMeasure(Iterations, [&] {
+      for(size_t i = 0; i < TransformCount; i++) {
+        affineResults[i] = affines[i].GetInverse();
+      }
+      BenchKeep(affineResults.data());
+    });
+    double matrixInverse = BenchMeasure(Iterations, [&] {
+      for(size_t i = 0; i < TransformCount; i++) {
+        matrixResults[i] = GetInverseMatrix(matrices[i]);
+      }
+      BenchKeep(matrixResults.data());
+    });
+
+    bool inverseMatches = NearlyEqual(affineResults[1], matrixResults[1]);
+
+    // One transform applied to many points, like the corners of a batch.
+    double affineApply = BenchMeasure(Iterations, [&] {
+      affines[0].Apply(points.data(), affinePoints.data(), TransformCount);
+      BenchKeep(affinePoints.data());
+    });
+    double matrixApply = BenchMeasure(Iterations, [&] {
+      for(size_t i = 0; i < TransformCount; i++) {
+        FPoint point = ApplyTransformation(matrices[0],
+            FPoint{points[i * 2], points[i * 2 + 1]});
+        matrixPoints[i * 2] = point.x;
+        matrixPoints[i * 2 + 1] = point.y;
+      }
+      BenchKeep(matrixPoints.data());
+    });
+
+    bool applyMatches = std::abs(affinePoints[2] - matrixPoints[2]) < 1e-2f &&
+        std::abs(affinePoints[3] - matrixPoints[3]) < 1e-2f;
+
+    std::printf("  %zu transforms per iteration\n", TransformCount);
+    BenchReport("compose, Affine2D", affineCompose);
+    BenchReport("compose, Matrix3", matrixCompose);
+    BenchReportSpeedup("compose speedup", matrixCompose, affineCompose);
+    BenchReport("inverse, Affine2D", affineInverse);
+    BenchReport("inverse, Matrix3", matrixInverse);
+    BenchReportSpeedup("inverse speedup", matrixInverse, affineInverse);
+    BenchReport("point transform, Affine2D", affineApply);
+    BenchReport("point transform, Matrix3", matrixApply);
+    BenchReportSpeedup("point transform speedup", matrixApply, affineApply);
+
+    bool passed = true;
+
+    if(!composeMatches || !inverseMatches || !applyMatches) {
+      std::printf("  Affine2D and Matrix3 results differ\n");
+      passed = false;
+    }
+
+    // Both sides of the point transform do the same arithmetic, only the
+    // compositions are expected to be cheaper.
+    if(affineCompose >= matrixCompose || affineInverse >= matrixInverse) {
+      std::printf("  Affine2D is not faster than Matrix3\n");
+      passed = false;
+    }
+
+    return passed;
+  }
+
+}
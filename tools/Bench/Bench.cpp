@@ -0,0 +1,57 @@
+/*
+ * neonGX - Bench.cpp
+ *
+ * Copyright (c) 2016, cynecx
+ *
+ * This file is part of neonGX and is distributed under a modified
+ * BSD 3-Clause License. See LICENSE.txt for details.
+ *
+ */
+
+// Microbenchmarks of the engine hot paths:
+//
+//   Bench [suite...]
+//
+// Without arguments every suite runs. Exits with 1 if a suite's check
+// failed, e.g. an optimized path being slower than its reference.
+
+#include "Bench.hpp"
+#include <cstring>
+#include <iostream>
+
+using namespace neonGX;
+
+struct BenchSuite {
+  const char* Name;
+  bool (*Run)();
+};
+
+static const BenchSuite Suites[] = {
+    { "sprites", RunSpritePackingBench },
+    { "text", RunTextBench },
+    { "spatial", RunSpatialIndexBench },
+    { "affine", RunAffineBench },
+};
+
+int main(int argc, char** argv) {
+  bool passed = true;
+
+  for(const BenchSuite& suite : Suites) {
+    bool selected = argc < 2;
+    for(int i = 1; i < argc; i++) {
+      selected |= std::strcmp(argv[i], suite.Name) == 0;
+    }
+
+    if(!selected) {
+      continue;
+    }
+
+    std::cout << suite.Name << ":\n" << std::flush;
+    if(!suite.Run()) {
+      std::cerr << "Bench: " << suite.Name << " failed its checks\n";
+      passed = false;
+    }
+  }
+
+  return passed ? 0 : 1;
+}
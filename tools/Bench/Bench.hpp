@@ -0,0 +1,69 @@
+/*
+ * neonGX - Bench.hpp
+ *
+ * Copyright (c) 2016, cynecx
+ *
+ * This file is part of neonGX and is distributed under a modified
+ * BSD 3-Clause License. See LICENSE.txt for details.
+ *
+ */
+
+#ifndef NEONGX_BENCH_H
+#define NEONGX_BENCH_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <limits>
+
+namespace neonGX {
+
+  // Runs function iterations times per round and returns the fastest round
+  // in nanoseconds per iteration, the minimum filters out scheduling noise.
+  template<typename Function>
+  double BenchMeasure(size_t iterations, Function&& function,
+                      size_t rounds = 5) {
+    using Clock = std::chrono::steady_clock;
+
+    // Warm up caches and lazily allocated state.
+    function();
+
+    double best = std::numeric_limits<double>::max();
+    for(size_t round = 0; round < rounds; round++) {
+      auto start = Clock::now();
+      for(size_t i = 0; i < iterations; i++) {
+        function();
+      }
+      std::chrono::duration<double, std::nano> elapsed = Clock::now() - start;
+      best = std::min(best, elapsed.count() / double(iterations));
+    }
+
+    return best;
+  }
+
+  // Keeps the compiler from discarding results which are never read.
+  template<typename T>
+  inline void BenchKeep(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+  }
+
+  inline void BenchReport(const char* name, double nanoseconds) {
+    std::printf("  %-44s %12.3f us\n", name, nanoseconds / 1000.0);
+  }
+
+  inline void BenchReportSpeedup(const char* name, double baseline,
+                            double optimized) {
+    std::printf("  %-44s %12.2fx\n", name, baseline / optimized);
+  }
+
+  // Every suite prints its results and returns false if one of its checks
+  // failed.
+  bool RunSpritePackingBench();
+  bool RunTextBench();
+  bool RunSpatialIndexBench();
+  bool RunAffineBench();
+
+} // end namespace neonGX
+
+#endif // !NEONGX_BENCH_H
@@ -0,0 +1,122 @@
+/*
+ * neonGX - SpatialIndexBench.cpp
+ *
+ * Copyright (c) 2016, cynecx
+ *
+ * This file is part of neonGX and is distributed under a modified
+ * BSD 3-Clause License. See LICENSE.txt for details.
+ *
+ */
+
+#include "Bench.hpp"
+#include <neonGX/Core/neonGX.hpp>
+#include <neonGX/Core/Display/Container.hpp>
+#include <neonGX/Core/Image/PNGImage.hpp>
+#include <neonGX/Core/Renderer/OpenGL/GLRenderer.hpp>
+#include <neonGX/Core/Sprites/Sprite.hpp>
+#include <neonGX/Core/Textures/BaseTexture.hpp>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace neonGX {
+
+  static constexpr size_t StaticObjects = 100000;
+  static constexpr size_t MovingObjects = 5000;
+  static constexpr size_t Frames = 10;
+
+  // A 40000 x 40000 world of static sprites with the moving ones clustered
+  // around the 1280 x 720 viewport, like a large scrolling map.
+  struct SpatialScene {
+    std::shared_ptr<Container> Root;
+    std::vector<std::shared_ptr<Sprite>> Moving;
+    size_t Frame = 0;
+
+    SpatialScene(const std::shared_ptr<Texture>& texture, bool indexed) {
+      std::mt19937 random(1);
+      std::uniform_real_distribution<float> world(-20000.0f, 20000.0f);
+      std::uniform_real_distribution<float> viewX(-200.0f, 1480.0f);
+      std::uniform_real_distribution<float> viewY(-200.0f, 920.0f);
+
+      Root = std::make_shared<Container>();
+      Root->SetSpatialIndexEnabled(indexed);
+
+      auto layer = std::make_shared<Container>();
+      Root->AddChild(layer);
+
+      for(size_t i = 0; i < StaticObjects; i++) {
+        auto sprite = std::make_shared<Sprite>(texture);
+        sprite->SetPosition(FPoint{world(random), world(random)});
+        layer->AddChild(sprite);
+      }
+
+      for(size_t i = 0; i < MovingObjects; i++) {
+        auto sprite = std::make_shared<Sprite>(texture);
+        sprite->SetPosition(FPoint{viewX(random), viewY(random)});
+        Root->AddChild(sprite);
+        Moving.push_back(sprite);
+      }
+    }
+
+    void Step() {
+      Frame++;
+      for(size_t i = 0; i < Moving.size(); i++) {
+        FPoint position = Moving[i]->GetPosition();
+        position.x += float((i + Frame) % 7) - 3.0f;
+        position.y += float((i * 3 + Frame) % 5) - 2.0f;
+        Moving[i]->SetPosition(position);
+      }
+    }
+  };
+
+  bool RunSpatialIndexBench() {
+    InitializeEngine();
+
+    RendererSettings settings;
+    GLRenderer renderer("Bench", FSize{1280, 720}, settings);
+
+    auto baseTexture = std::make_shared<BaseTexture>();
+    baseTexture->SetImage(LoadPNGImageShared(
+        NEONGX_BENCH_ASSETS_DIR "/sprites/ball_blue.png"));
+    auto texture = std::make_shared<Texture>(baseTexture, nullopt);
+
+    SpatialScene walked(texture, false);
+    SpatialScene indexed(texture, true);
+
+    double walk = BenchMeasure(Frames, [&] {
+      walked.Step();
+      renderer.Render(walked.Root.get());
+    });
+    size_t walkedSprites = renderer.GetStats().Sprites;
+    float walkTraversal = renderer.GetStats().TraversalTime;
+
+    double query = BenchMeasure(Frames, [&] {
+      indexed.Step();
+      renderer.Render(indexed.Root.get());
+    });
+    size_t indexedSprites = renderer.GetStats().Sprites;
+    float queryTraversal = renderer.GetStats().TraversalTime;
+
+    std::printf("  %zu static and %zu moving sprites, %zu drawn\n",
+        StaticObjects, MovingObjects, indexedSprites);
+    BenchReport("frame, culled tree walk", walk);
+    BenchReport("frame, spatial index", query);
+    BenchReportSpeedup("speedup", walk, query);
+    BenchReport("traversal, culled tree walk", walkTraversal * 1e6);
+    BenchReport("traversal, spatial index", queryTraversal * 1e6);
+
+    // Both scenes move the same way, they have to draw the same sprites.
+    if(walkedSprites != indexedSprites) {
+      std::printf("  the tree walk drew %zu sprites\n", walkedSprites);
+      return false;
+    }
+
+    if(query >= walk) {
+      std::printf("  the spatial index is not faster than the tree walk\n");
+      return false;
+    }
+
+    return true;
+  }
+
+}
@@ -0,0 +1,86 @@
+/*
+ * neonGX - SpritePackingBench.cpp
+ *
+ * Copyright (c) 2016, cynecx
+ *
+ * This file is part of neonGX and is distributed under a modified
+ * BSD 3-Clause License. See LICENSE.txt for details.
+ *
+ */
+
+#include "Bench.hpp"
+#include <neonGX/Core/Sprites/SpriteVertexPacker.hpp>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace neonGX {
+
+  // Bytes PackSpriteVertices writes per record, 4 vertices of 24 bytes.
+  static constexpr size_t PackedRecordByteSize = 4 * 6 * sizeof(float);
+
+  static std::vector<SpriteVertexRecord> CreateRecords(size_t count) {
+    std::mt19937 random(count);
+    std::uniform_real_distribution<float> position(0.0f, 1920.0f);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+    std::vector<SpriteVertexRecord> records(count);
+    for(SpriteVertexRecord& record : records) {
+      float x = position(random);
+      float y = position(random);
+      record.Positions = { x, y, x + 32.0f, y, x + 32.0f, y + 32.0f,
+                           x, y + 32.0f };
+      record.UVs = { 0.0f, 0.0f, 1.0f, 0.0f, 1.0f, 1.0f, 0.0f, 1.0f };
+      record.Tint = uint32_t(unit(random) * 0xFFFFFF);
+      record.Alpha = unit(random);
+      record.TextureId = float(random() % 8);
+      record.Texture = nullptr;
+    }
+
+    return records;
+  }
+
+  bool RunSpritePackingBench() {
+    bool passed = true;
+
+    for(size_t count : { size_t(10000), size_t(100000) }) {
+      std::vector<SpriteVertexRecord> records = CreateRecords(count);
+      std::vector<uint8_t> simdOutput(count * PackedRecordByteSize);
+      std::vector<uint8_t> scalarOutput(count * PackedRecordByteSize);
+
+      size_t iterations = 1000000 / count;
+
+      double simd = BenchMeasure(iterations, [&] {
+        PackSpriteVertices(records.data(), count, simdOutput.data());
+        BenchKeep(simdOutput.data());
+      });
+      double scalar = BenchMeasure(iterations, [&] {
+        PackSpriteVerticesScalar(records.data(), count, scalarOutput.data());
+        BenchKeep(scalarOutput.data());
+      });
+
+      std::string suffix = " (" + std::to_string(count) + " sprites)";
+      BenchReport(("PackSpriteVertices" + suffix).c_str(), simd);
+      BenchReport(("PackSpriteVerticesScalar" + suffix).c_str(), scalar);
+      BenchReportSpeedup(("speedup" + suffix).c_str(), scalar, simd);
+
+      if(std::memcmp(simdOutput.data(), scalarOutput.data(),
+                     simdOutput.size()) != 0) {
+        std::printf("  output differs from PackSpriteVerticesScalar\n");
+        passed = false;
+      }
+
+#if defined(__SSE2__) || defined(__wasm_simd128__)
+      // Only large batches amortize the per call overhead reliably.
+      if(count >= 100000 && simd >= scalar) {
+        std::printf("  SIMD packing is not faster than the scalar one\n");
+        passed = false;
+      }
+#endif
+    }
+
+    return passed;
+  }
+
+}
@@ -0,0 +1,234 @@
+/*
+ * neonGX - TextBench.cpp
+ *
+ * Copyright (c) 2016, cynecx
+ *
+ * This file is part of neonGX and is distributed under a modified
+ * BSD 3-Clause License. See LICENSE.txt for details.
+ *
+ */
+
+#include "Bench.hpp"
+#include <neonGX/Core/neonGX.hpp>
+#include <neonGX/Core/Display/Container.hpp>
+#include <neonGX/Core/Renderer/OpenGL/GLRenderer.hpp>
+#include <neonGX/Core/Text/FontTextureManager.hpp>
+#include <neonGX/Core/Text/Text.hpp>
+#include <neonGX/Core/Text/TextRenderer.hpp>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace neonGX {
+
+  static constexpr size_t LabelCount = 5000;
+  static constexpr size_t LabelColumns = 50;
+  static constexpr size_t Frames = 20;
+  static constexpr float FontSize = 12.0f;
+
+  // Writes the four vertices of a glyph quad in the default vertex format,
+  // position, texture coordinates and color as floats.
+  static uint8_t* WriteGlyphVertices(uint8_t* output, const float* positions,
+                                     const std::array<float, 4>& uvs,
+                                     const float* rgb) {
+    const float corners[8] = {
+        uvs[0], uvs[1], uvs[2], uvs[1], uvs[2], uvs[3], uvs[0], uvs[3]
+    };
+
+    for(size_t corner = 0; corner < 8; corner += 2) {
+      std::memcpy(output, positions + corner, 2 * sizeof(float));
+      std::memcpy(output + 2 * sizeof(float), corners + corner,
+          2 * sizeof(float));
+      std::memcpy(output + 4 * sizeof(float), rgb, 3 * sizeof(float));
+      output += 7 * sizeof(float);
+    }
+
+    return output;
+  }
+
+  // The vertex fill TextRenderer::Flush did before the glyph quads were
+  // cached: every frame looks the font up by name, lays the whole text out
+  // again and resolves every glyph a second time while writing it.
+  static size_t FillReferenceVertices(FontTextureManager& fontManager,
+      const std::vector<std::shared_ptr<Text>>& labels,
+      const std::vector<std::u32string>& codepoints,
+      std::vector<float>& positions, std::vector<uint8_t>& vertices) {
+    uint8_t* output = vertices.data();
+
+    for(size_t label = 0; label < labels.size(); label++) {
+      const Text& text = *labels[label];
+      FontData* fontData = fontManager.GetFontData("MinimalHard42").value();
+      const std::u32string& chars = codepoints[label];
+      float scale = FontSize / float(fontData->Height);
+
+      positions.resize(chars.size() * 8);
+
+      float currentX = 0.0f;
+      for(size_t i = 0; i < chars.size(); i++) {
+        if(i > 0) {
+          int32_t kerning = fontManager.GetKerning(*fontData, chars[i - 1],
+              chars[i]);
+          currentX += float(kerning >> 6) * scale;
+        }
+
+        const auto& glyphInfo = fontManager.GetCharacter(*fontData,
+            chars[i]);
+
+        float x0 = currentX + float(glyphInfo.BearingX) * scale;
+        float y0 = float(glyphInfo.DescentY - glyphInfo.BearingY) * scale;
+        float x1 = x0 + glyphInfo.Size.width * scale;
+        float y1 = y0 + glyphInfo.Size.height * scale;
+        const float corners[8] = { x0, y0, x1, y0, x1, y1, x0, y1 };
+        text.GetWorldTransform().Apply(corners, positions.data() + i * 8, 4);
+
+        currentX += float(glyphInfo.AdvanceX >> 6) * scale;
+      }
+
+      const float rgb[3] = { 0.0f, 0.0f, 0.0f };
+      for(size_t i = 0; i < chars.size(); i++) {
+        const auto& glyphInfo = fontManager.GetCharacter(*fontData,
+            chars[i]);
+        if(glyphInfo.Size.IsZero()) {
+          continue;
+        }
+
+        output = WriteGlyphVertices(output, positions.data() + i * 8,
+            glyphInfo.UVs, rgb);
+      }
+    }
+
+    return size_t(output - vertices.data());
+  }
+
+  // The vertex fill of TextRenderer::Flush, copying the cached glyph quads
+  // after validating their atlas pages.
+  static size_t FillCachedVertices(FontTextureManager& fontManager,
+      const std::vector<std::shared_ptr<Text>>& labels,
+      std::vector<uint8_t>& vertices) {
+    uint8_t* output = vertices.data();
+
+    for(const std::shared_ptr<Text>& label : labels) {
+      TextRenderer::ValidateGlyphs(fontManager, *label);
+      TextRun run = TextRenderer::GetTextRun(*label);
+
+      const float rgb[3] = {
+          float(run.Color.r) / 255, float(run.Color.g) / 255,
+          float(run.Color.b) / 255
+      };
+      for(size_t i = 0; i < run.GlyphCount; i++) {
+        output = WriteGlyphVertices(output, run.Glyphs[i].Positions.data(),
+            run.Glyphs[i].UVs, rgb);
+      }
+    }
+
+    return size_t(output - vertices.data());
+  }
+
+  bool RunTextBench() {
+    InitializeEngine();
+
+    RendererSettings settings;
+    settings.CullOffscreen = false;
+    GLRenderer renderer("Bench", FSize{1280, 720}, settings);
+
+    auto fontManager = renderer.GetFontTextureManager();
+    if(!fontManager->LoadFontPack(
+        NEONGX_BENCH_ASSETS_DIR "/fonts/mh.ngxfont", "MinimalHard42")) {
+      std::printf("  failed to load mh.ngxfont\n");
+      return false;
+    }
+
+    auto root = std::make_shared<Container>();
+    std::vector<std::shared_ptr<Text>> labels;
+
+    for(size_t i = 0; i < LabelCount; i++) {
+      auto label = std::make_shared<Text>(
+          "Label " + std::to_string(i), "MinimalHard42");
+      label->SetFontSize(FontSize);
+      label->SetPosition(FPoint{
+          float(i % LabelColumns) * 25.0f,
+          float(i / LabelColumns) * 7.0f
+      });
+      root->AddChild(label);
+      labels.push_back(label);
+    }
+
+    // Nothing changed, Flush copies the cached glyph quads.
+    double unchanged = BenchMeasure(Frames, [&] {
+      renderer.Render(root.get());
+    });
+
+    // A moved parent refills every quad from the cached layout.
+    float offset = 0.0f;
+    double moved = BenchMeasure(Frames, [&] {
+      offset = offset == 0.0f ? 1.0f : 0.0f;
+      root->SetPosition(FPoint{offset, 0.0f});
+      renderer.Render(root.get());
+    });
+
+    // New text lays out the changed suffix and resolves its glyphs again.
+    size_t frame = 0;
+    double relaidOut = BenchMeasure(Frames, [&] {
+      frame++;
+      for(size_t i = 0; i < LabelCount; i++) {
+        labels[i]->SetText("Label " + std::to_string(i + frame));
+      }
+      renderer.Render(root.get());
+    });
+
+    const GLRendererStats& stats = renderer.GetStats();
+    std::printf("  %zu labels, %zu render commands, %zu draw calls\n",
+        LabelCount, stats.Commands, stats.DrawCalls);
+    BenchReport("frame, unchanged labels", unchanged);
+    BenchReport("frame, moved labels", moved);
+    BenchReport("frame, new label text", relaidOut);
+
+    // The GL side of a flush did not change, only the vertex fill did.
+    std::vector<std::u32string> codepoints;
+    size_t glyphCount = 0;
+    for(const std::shared_ptr<Text>& label : labels) {
+      codepoints.push_back(DecodeUTF8(label->GetText()));
+      glyphCount += codepoints.back().size();
+    }
+
+    std::vector<float> positions;
+    std::vector<uint8_t> referenceVertices(glyphCount * 4 * 7 * sizeof(float));
+    std::vector<uint8_t> cachedVertices(referenceVertices.size());
+    size_t referenceBytes = 0;
+    size_t cachedBytes = 0;
+
+    double reference = BenchMeasure(Frames, [&] {
+      referenceBytes = FillReferenceVertices(*fontManager, labels,
+          codepoints, positions, referenceVertices);
+      BenchKeep(referenceVertices.data());
+    });
+
+    double cached = BenchMeasure(Frames, [&] {
+      cachedBytes = FillCachedVertices(*fontManager, labels, cachedVertices);
+      BenchKeep(cachedVertices.data());
+    });
+
+    BenchReport("vertex fill, per glyph lookups", reference);
+    BenchReport("vertex fill, cached glyph quads", cached);
+    BenchReportSpeedup("speedup", reference, cached);
+
+    bool passed = stats.Commands == LabelCount;
+
+    // Both paths have to produce the very same vertices.
+    if(referenceBytes != cachedBytes ||
+       std::memcmp(referenceVertices.data(), cachedVertices.data(),
+                   cachedBytes) != 0) {
+      std::printf("  the cached glyph quads differ from the reference\n");
+      passed = false;
+    }
+
+    if(cached >= reference) {
+      std::printf("  the cached glyph quads are not faster\n");
+      passed = false;
+    }
+
+    return passed;
+  }
+
+}
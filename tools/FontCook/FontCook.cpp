@@ -0,0 +1,197 @@
+/*
+ * neonGX - FontCook.cpp
+ *
+ * Copyright (c) 2016, cynecx
+ *
+ * This file is part of neonGX and is distributed under a modified
+ * BSD 3-Clause License. See LICENSE.txt for details.
+ *
+ */
+
+// Cooks a TrueType font into a font pack (see FontPack.hpp) which neonGX
+// loads without FreeType:
+//
+//   FontCook <font.ttf> <height> <output> [--sdf] [--atlas-size <pixels>]
+//            [--chars <utf-8 text>]
+//
+// Without --chars, printable ASCII and Latin-1 get cooked.
+
+#include <neonGX/Core/Text/FontPack.hpp>
+#include <neonGX/Core/Text/GlyphRasterizer.hpp>
+#include <neonGX/Core/Text/SkylinePacker.hpp>
+#include <neonGX/Core/Text/UTF8.hpp>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+using namespace neonGX;
+
+// Same border GlyphAtlas keeps around every glyph.
+static constexpr int32_t Padding = 1;
+
+static int Usage() {
+  std::cerr << "usage: FontCook <font.ttf> <height> <output> [--sdf] "
+               "[--atlas-size <pixels>] [--chars <utf-8 text>]\n";
+  return 1;
+}
+
+int main(int argc, char** argv) {
+  if(argc < 4) {
+    return Usage();
+  }
+
+  std::string fontFile = argv[1];
+  size_t height = size_t(std::strtoul(argv[2], nullptr, 10));
+  std::string output = argv[3];
+
+  FontRenderMode mode = FontRenderMode::Bitmap;
+  int32_t atlasSize = 512;
+  std::u32string codepoints;
+
+  for(int i = 4; i < argc; i++) {
+    if(std::strcmp(argv[i], "--sdf") == 0) {
+      mode = FontRenderMode::DistanceField;
+    } else if(std::strcmp(argv[i], "--atlas-size") == 0 && i + 1 < argc) {
+      atlasSize = int32_t(std::strtol(argv[++i], nullptr, 10));
+    } else if(std::strcmp(argv[i], "--chars") == 0 && i + 1 < argc) {
+      codepoints = DecodeUTF8(argv[++i]);
+    } else {
+      return Usage();
+    }
+  }
+
+  // The atlas becomes a single pinned page, rows stay 4 byte aligned.
+  if(height == 0 || atlasSize <= 0 || atlasSize > 1024 ||
+     atlasSize % 4 != 0) {
+    return Usage();
+  }
+
+  if(codepoints.empty()) {
+    for(char32_t codepoint = 0x20; codepoint < 0x7F; codepoint++) {
+      codepoints.push_back(codepoint);
+    }
+    for(char32_t codepoint = 0xA0; codepoint <= 0xFF; codepoint++) {
+      codepoints.push_back(codepoint);
+    }
+  }
+
+  std::sort(codepoints.begin(), codepoints.end());
+  codepoints.erase(std::unique(codepoints.begin(), codepoints.end()),
+      codepoints.end());
+
+  FT_Library library = nullptr;
+  if(FT_Init_FreeType(&library)) {
+    std::cerr << "FontCook: failed to initialize FreeType\n";
+    return 1;
+  }
+
+  FT_Face face = OpenFontFace(library, fontFile, height);
+  if(!face) {
+    std::cerr << "FontCook: failed to open " << fontFile << "\n";
+    FT_Done_FreeType(library);
+    return 1;
+  }
+
+  std::vector<RasterizedGlyph> glyphs;
+  for(char32_t codepoint : codepoints) {
+    if(FT_Get_Char_Index(face, FT_ULong(codepoint)) == 0 &&
+       codepoint != U'?') {
+      continue;
+    }
+    glyphs.push_back(RasterizeGlyph(face, codepoint, mode));
+  }
+
+  std::vector<FontPackKerning> kernings;
+  if(FT_HAS_KERNING(face)) {
+    for(const RasterizedGlyph& left : glyphs) {
+      for(const RasterizedGlyph& right : glyphs) {
+        FT_Vector delta;
+        if(FT_Get_Kerning(face, FT_Get_Char_Index(face, left.Codepoint),
+            FT_Get_Char_Index(face, right.Codepoint), FT_KERNING_DEFAULT,
+            &delta) || delta.x == 0) {
+          continue;
+        }
+
+        kernings.push_back(FontPackKerning{
+            uint32_t(left.Codepoint), uint32_t(right.Codepoint),
+            int32_t(delta.x)
+        });
+      }
+    }
+  }
+
+  FontPackHeader header;
+  header.Magic = FontPackMagic;
+  header.Version = FontPackVersion;
+  header.Height = uint32_t(height);
+  header.Mode = uint32_t(mode);
+  header.Ascender = int32_t(face->size->metrics.ascender >> 6);
+  header.AtlasWidth = uint32_t(atlasSize);
+  header.AtlasHeight = uint32_t(atlasSize);
+  header.GlyphCount = uint32_t(glyphs.size());
+  header.KerningCount = uint32_t(kernings.size());
+
+  FT_Done_Face(face);
+  FT_Done_FreeType(library);
+
+  // Tall glyphs first pack tighter.
+  std::vector<size_t> order(glyphs.size());
+  for(size_t i = 0; i < order.size(); i++) {
+    order[i] = i;
+  }
+  std::stable_sort(order.begin(), order.end(), [&glyphs] (size_t lhs,
+                                                          size_t rhs) {
+    return glyphs[lhs].Height > glyphs[rhs].Height;
+  });
+
+  SkylinePacker packer(atlasSize, atlasSize);
+  std::vector<uint8_t> atlas(size_t(atlasSize) * size_t(atlasSize), 0);
+  std::vector<FontPackGlyph> packGlyphs(glyphs.size());
+
+  for(size_t index : order) {
+    const RasterizedGlyph& glyph = glyphs[index];
+
+    FontPackGlyph& packGlyph = packGlyphs[index];
+    packGlyph = FontPackGlyph{
+        uint32_t(glyph.Codepoint), 0, 0, 0, 0,
+        int16_t(glyph.BearingX), int16_t(glyph.BearingY), glyph.AdvanceX
+    };
+
+    if(glyph.Width == 0 || glyph.Height == 0) {
+      continue;
+    }
+
+    auto position = packer.Insert(glyph.Width + 2 * Padding,
+        glyph.Height + 2 * Padding);
+    if(!position) {
+      std::cerr << "FontCook: glyphs don't fit into a " << atlasSize << "x"
+                << atlasSize << " atlas, raise --atlas-size\n";
+      return 1;
+    }
+
+    int32_t x = position->x + Padding;
+    int32_t y = position->y + Padding;
+
+    for(int32_t row = 0; row < glyph.Height; row++) {
+      std::memcpy(atlas.data() + size_t(y + row) * size_t(atlasSize) +
+          size_t(x), glyph.Pixels.data() + size_t(row) * size_t(glyph.Width),
+          size_t(glyph.Width));
+    }
+
+    packGlyph.X = uint16_t(x);
+    packGlyph.Y = uint16_t(y);
+    packGlyph.Width = uint16_t(glyph.Width);
+    packGlyph.Height = uint16_t(glyph.Height);
+  }
+
+  if(!WriteFontPack(output, header, packGlyphs, kernings, atlas)) {
+    std::cerr << "FontCook: failed to write " << output << "\n";
+    return 1;
+  }
+
+  std::cout << "FontCook: " << glyphs.size() << " glyphs, "
+            << kernings.size() << " kerning pairs -> " << output << "\n";
+
+  return 0;
+}